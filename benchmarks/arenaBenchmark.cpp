@@ -0,0 +1,109 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+
+#include "../src/input.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+// every heap allocation of the program, including the blocks of the arenas
+atomic<size_t> allocations = 0;
+atomic<size_t> allocatedBytes = 0;
+
+void* operator new(const size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    if(void* memory = malloc(size)) return memory;
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// memory resources allocate with an alignment
+void* operator new(const size_t size, const align_val_t alignment) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    const auto align = static_cast<size_t>(alignment);
+    if(void* memory = aligned_alloc(align, (size + align - 1) / align * align)) return memory;
+    throw bad_alloc();
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+
+/**
+ * Builds a document of at least targetSize bytes by repeating the fixture under numbered keys
+ *
+ * @param fixture JSON object used as the value of every key
+ * @param targetSize minimum size of the document in bytes
+ * @return scaled up JSON document
+ */
+string scaleDocument(const string& fixture, const size_t targetSize) {
+    string document = "{";
+    for(long long i = 0; document.size() < targetSize; i++) {
+        if(i > 0) document += ',';
+        document += "\"k" + to_string(i) + "\":" + fixture;
+    }
+    document += '}';
+    return document;
+}
+
+/**
+ * Parses the document, destroys the result and prints the allocations and times of both.
+ * The bytes of blocks freed while parsing are counted as well
+ *
+ * @param name name of the measured variant
+ * @param parse parses the document and returns the owner of the values
+ */
+template<typename F>
+void measure(const string& name, F parse) {
+    const size_t allocationsBefore = allocations.load();
+    const size_t bytesBefore = allocatedBytes.load();
+    const auto start = chrono::steady_clock::now();
+    optional result(parse());
+    const auto parsed = chrono::steady_clock::now();
+    const size_t allocated = allocations.load() - allocationsBefore;
+    const size_t bytes = allocatedBytes.load() - bytesBefore;
+    result.reset();
+    const auto destroyed = chrono::steady_clock::now();
+    const chrono::duration<double> parseTime = parsed - start;
+    const chrono::duration<double> destroyTime = destroyed - parsed;
+    cout << "  " << name << ": " << allocated << " allocations of " << bytes / (1024 * 1024)
+         << " MB, parsed in " << parseTime.count()
+         << " s, destroyed in " << destroyTime.count() << " s" << endl;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? stoull(argv[1]) : 100;
+    for(const string fixtureName : {"everything.json", "bigNoArrays.json"}) {
+        const InputJSON input(string(BENCHMARK_DATA_DIR) + "/complex/" + fixtureName);
+        const string document = scaleDocument(string(input.view()), megabytes * 1024 * 1024);
+        cout << fixtureName << " scaled to " << document.size() / (1024 * 1024) << " MB" << endl;
+        measure("heap ", [&] { return parseJSON(document); });
+        measure("arena", [&] { return DocumentJSON(document); });
+        // borrowing needs an input the document can keep, the scaled document is mapped back from a file
+        const string filePath = (filesystem::temp_directory_path() / "arenaBenchmark.json").string();
+        ofstream(filePath, ios::binary | ios::trunc) << document;
+        const auto mapped = make_shared<const InputJSON>(filePath);
+        measure("borrowing arena", [&] { return DocumentJSON(mapped); });
+        filesystem::remove(filePath);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "../src/batch.h"
+#include "../src/bytecode.h"
+#include "../src/execute.h"
+#include "../src/expression.h"
+#include "../src/input.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+/**
+ * Builds a document of at least targetSize bytes by repeating the fixture under numbered keys
+ *
+ * @param fixture JSON object used as the value of every key
+ * @param targetSize minimum size of the document in bytes
+ * @return scaled up JSON document and the number of keys
+ */
+pair<string, long long> scaleDocument(const string& fixture, const size_t targetSize) {
+    string document = "{";
+    long long keys = 0;
+    for(; document.size() < targetSize; keys++) {
+        if(keys > 0) document += ',';
+        document += "\"k" + to_string(keys) + "\":" + fixture;
+    }
+    document += '}';
+    return {document, keys};
+}
+
+/**
+ * Runs the batch until enough time passed and prints the throughput
+ *
+ * @param name name of the measured evaluator
+ * @param size number of expressions in the batch
+ * @param run evaluates the whole batch and returns a checksum of the results
+ */
+template<typename Run>
+void measure(const string& name, const size_t size, Run run) {
+    size_t checksum = 0;
+    size_t batches = 0;
+    const auto start = chrono::steady_clock::now();
+    chrono::duration<double> time{};
+    while(time.count() < 1) {
+        checksum += run();
+        batches++;
+        time = chrono::steady_clock::now() - start;
+    }
+    cout << "  " << name << ": " << static_cast<size_t>(batches * size / time.count())
+         << " evaluations/s (checksum " << checksum / batches << ")" << endl;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? stoull(argv[1]) : 10;
+    const size_t reports = argc > 2 ? stoull(argv[2]) : 50;
+    const InputJSON input(string(BENCHMARK_DATA_DIR) + "/complex/everything.json");
+    const auto [document, keys] = scaleDocument(string(input.view()), megabytes * 1024 * 1024);
+    const ObjectJSON JSON = parseJSON(document);
+    cout << "everything.json scaled to " << document.size() / (1024 * 1024) << " MB" << endl;
+
+    // one report is 20 expressions on the record under a random top-level key, $ is replaced by the key
+    const vector<string> report = {
+        "$.person.name", "$.person.age", "$.person.height * $.person.weight", "size($.person.children)",
+        "$.person.education.college.degrees[0].gpa", "$.person.education.college.degrees[1].gpa",
+        "$.person.education.college.graduation_year - $.person.age",
+        "$.person.employment.current_job.salary.base", "$.person.employment.current_job.salary.bonus",
+        "$.person.employment.current_job.salary.base + $.person.employment.current_job.salary.bonus",
+        "$.person.employment.current_job.company.employee_count",
+        "$.person.employment.previous_jobs[0].salary", "$.person.employment.previous_jobs[1].salary",
+        "max($.person.employment.previous_jobs[0].salary, $.person.employment.previous_jobs[1].salary)",
+        "$.person.financials.bank_accounts[0].balance", "$.person.financials.bank_accounts[1].balance",
+        "$.person.financials.credit_cards[0].limit", "$.person.financials.credit_cards[1].limit",
+        "size($.person.hobbies)", "$.person.hobbies[size($.person.hobbies) - 1].name"
+    };
+    mt19937 random(42);
+    uniform_int_distribution<long long> key(0, keys - 1);
+    vector<shared_ptr<const Bytecode>> programs;
+    for(size_t i = 0; i < reports; i++) {
+        const string top = "k" + to_string(key(random));
+        for(const string& expressionTemplate : report) {
+            string expression;
+            for(const char c : expressionTemplate) {
+                if(c == '$') expression += top;
+                else expression += c;
+            }
+            programs.push_back(make_shared<const Bytecode>(compileExpression(parseExpression(expression))));
+        }
+    }
+    const Batch batch = compileBatch(programs);
+    cout << "batch of " << programs.size() << " expressions in " << reports << " reports, "
+         << batch.trie.size() - 1 << " distinct path steps" << endl;
+
+    measure("tree walk one by one", programs.size(), [&] {
+        size_t checksum = 0;
+        for(const auto& program : programs) checksum += executeExpression(JSON, program->expression)->type;
+        return checksum;
+    });
+    measure("bytecode one by one", programs.size(), [&] {
+        size_t checksum = 0;
+        for(const auto& program : programs) checksum += executeBytecode(JSON, *program)->type;
+        return checksum;
+    });
+    measure("batch", programs.size(), [&] {
+        size_t checksum = 0;
+        for(const ResultJSON& result : executeBatch(JSON, batch)) checksum += result->type;
+        return checksum;
+    });
+    return 0;
+}
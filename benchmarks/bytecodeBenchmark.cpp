@@ -0,0 +1,92 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "../src/bytecode.h"
+#include "../src/execute.h"
+#include "../src/expression.h"
+#include "../src/input.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+/**
+ * Builds a document of at least targetSize bytes by repeating the fixture under numbered keys
+ *
+ * @param fixture JSON object used as the value of every key
+ * @param targetSize minimum size of the document in bytes
+ * @return scaled up JSON document and the number of keys
+ */
+pair<string, long long> scaleDocument(const string& fixture, const size_t targetSize) {
+    string document = "{";
+    long long keys = 0;
+    for(; document.size() < targetSize; keys++) {
+        if(keys > 0) document += ',';
+        document += "\"k" + to_string(keys) + "\":" + fixture;
+    }
+    document += '}';
+    return {document, keys};
+}
+
+/**
+ * Evaluates every expression with the run function until enough time passed and prints the throughput
+ *
+ * @param name name of the measured evaluator
+ * @param count number of expressions
+ * @param run evaluates the expression with the given index and returns the size of its result as text
+ */
+template<typename Run>
+void measure(const string& name, const size_t count, Run run) {
+    size_t checksum = 0;
+    size_t evaluations = 0;
+    const auto start = chrono::steady_clock::now();
+    chrono::duration<double> time{};
+    while(time.count() < 1) {
+        for(size_t i = 0; i < count; i++) checksum += run(i);
+        evaluations += count;
+        time = chrono::steady_clock::now() - start;
+    }
+    cout << "  " << name << ": " << static_cast<size_t>(evaluations / time.count())
+         << " evaluations/s (checksum " << checksum / evaluations << ")" << endl;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? stoull(argv[1]) : 10;
+    const size_t count = argc > 2 ? stoull(argv[2]) : 1000;
+    const InputJSON input(string(BENCHMARK_DATA_DIR) + "/complex/everything.json");
+    const auto [document, keys] = scaleDocument(string(input.view()), megabytes * 1024 * 1024);
+    const ObjectJSON JSON = parseJSON(document);
+    cout << "everything.json scaled to " << document.size() / (1024 * 1024) << " MB" << endl;
+
+    // paths, arithmetic and functions, $ is replaced by a random top-level key
+    const vector<string> templates = {
+        "$.person.education.college.degrees[1].gpa",
+        "$.person.age * 2 + $.person.age ^ 2 - 1",
+        "max($.person.age, size($.person.hobbies), 3.5)",
+        "$.person.hobbies[size($.person.hobbies) - 1].name"
+    };
+    for(const string& expressionTemplate : templates) {
+        mt19937 random(42);
+        uniform_int_distribution<long long> key(0, keys - 1);
+        vector<Node> expressions;
+        vector<Bytecode> programs;
+        for(size_t i = 0; i < count; i++) {
+            const string top = "k" + to_string(key(random));
+            string expression;
+            for(const char c : expressionTemplate) {
+                if(c == '$') expression += top;
+                else expression += c;
+            }
+            expressions.push_back(parseExpression(expression));
+            programs.push_back(compileExpression(parseExpression(expression)));
+        }
+        cout << expressionTemplate << endl;
+        measure("tree walk", count, [&](const size_t i) {
+            return toString(executeExpression(JSON, expressions[i])).size();
+        });
+        measure("bytecode", count, [&](const size_t i) {
+            return toString(executeBytecode(JSON, programs[i])).size();
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "../src/number.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+/**
+ * Builds an object with one array of integers and one array of floating point numbers
+ *
+ * @param count number of items in each array
+ * @return JSON document
+ */
+string numberDocument(const size_t count) {
+    mt19937_64 random(42);
+    uniform_int_distribution<long long> integers(-1000000000, 1000000000);
+    uniform_real_distribution<double> floats(-1e6, 1e6);
+    string document = R"({"integers": [)";
+    for(size_t i = 0; i < count; i++) {
+        if(i > 0) document += ',';
+        document += to_string(integers(random));
+    }
+    document += R"(], "floats": [)";
+    for(size_t i = 0; i < count; i++) {
+        if(i > 0) document += ',';
+        document += to_string(floats(random));
+    }
+    document += "]}";
+    return document;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t count = argc > 1 ? stoull(argv[1]) : 5000000;
+    const string document = numberDocument(count);
+
+    const auto start = chrono::steady_clock::now();
+    const auto result = parseJSON(document);
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    const double size = static_cast<double>(document.size()) / (1024 * 1024);
+    cout << "parsed " << 2 * count << " numbers, " << size << " MB in " << elapsed.count() << " s ("
+         << 2 * count / elapsed.count() / 1e6 << " M numbers/s)" << endl;
+
+    // number decoding alone, every number starts after a '[' or ','
+    const auto decodeStart = chrono::steady_clock::now();
+    size_t decoded = 0;
+    double checksum = 0;
+    for(string_view::size_type pos = 0; pos < document.size(); pos++) {
+        if(document[pos] != '[' && document[pos] != ',') continue;
+        long long integer;
+        double floating;
+        pos++;
+        const NumberType type = parseNumber(document, pos, integer, floating);
+        checksum += type == INTEGER_NUMBER ? static_cast<double>(integer) : floating;
+        decoded++;
+        pos--;
+    }
+    const chrono::duration<double> decodeElapsed = chrono::steady_clock::now() - decodeStart;
+    cout << "decoded " << decoded << " numbers in " << decodeElapsed.count() << " s ("
+         << decoded / decodeElapsed.count() / 1e6 << " M numbers/s, checksum " << checksum << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "../src/execute.h"
+#include "../src/expression.h"
+#include "../src/numeric.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+/**
+ * Builds an object with a column of integers, a column of floating point numbers
+ * and an array of both that holds values
+ *
+ * @param count number of items in each array
+ * @return JSON document
+ */
+string numericDocument(const size_t count) {
+    mt19937_64 random(42);
+    uniform_int_distribution<long long> integers(-1000000000, 1000000000);
+    uniform_real_distribution<double> floats(-1e6, 1e6);
+    string document = R"({"integers": [)";
+    for(size_t i = 0; i < count; i++) {
+        if(i > 0) document += ',';
+        document += to_string(integers(random));
+    }
+    document += R"(], "floats": [)";
+    for(size_t i = 0; i < count; i++) {
+        if(i > 0) document += ',';
+        document += to_string(floats(random));
+    }
+    document += R"(], "mixed": [)";
+    for(size_t i = 0; i < count; i++) {
+        if(i > 0) document += ',';
+        document += i % 2 == 0 ? to_string(integers(random)) : to_string(floats(random));
+    }
+    document += "]}";
+    return document;
+}
+
+/**
+ * Runs the reduction until enough time passed and prints the throughput
+ *
+ * @param name name of the measured reduction
+ * @param count number of items it reduces
+ * @param run reduces the array once and returns the result as a double
+ */
+template<typename Run>
+void measure(const string& name, const size_t count, Run run) {
+    double checksum = 0;
+    size_t runs = 0;
+    const auto start = chrono::steady_clock::now();
+    chrono::duration<double> time{};
+    while(time.count() < 1) {
+        checksum += run();
+        runs++;
+        time = chrono::steady_clock::now() - start;
+    }
+    cout << "  " << name << ": " << static_cast<double>(runs * count) / time.count() / 1e9
+         << " G items/s (result " << checksum / static_cast<double>(runs) << ")" << endl;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t count = argc > 1 ? stoull(argv[1]) : 10000000;
+    const ObjectJSON JSON = parseJSON(numericDocument(count));
+    cout << "arrays of " << count << " numbers, kernels use " << numericInstructionSet() << endl;
+
+    const ArrayJSON& integers = JSON.at("integers").asArray();
+    const ArrayJSON& floats = JSON.at("floats").asArray();
+    measure("scalar max of integers", count, [&] {
+        return static_cast<double>(findExtremeScalar(integers.integers(), true));
+    });
+    measure("max of integers", count, [&] { return static_cast<double>(findExtreme(integers.integers(), true)); });
+    measure("scalar min of floats", count, [&] { return findExtremeScalar(floats.floats(), false); });
+    measure("min of floats", count, [&] { return findExtreme(floats.floats(), false); });
+
+    for(const string expression : {"max(integers)", "min(floats)", "max(mixed)", "sum(integers)", "sum(floats)",
+                                   "avg(mixed)", "stddev(floats)"}) {
+        const Node parsed = parseExpression(expression);
+        measure(expression, count, [&] {
+            const ResultJSON result = executeExpression(JSON, parsed);
+            return result->type == INT ? static_cast<double>(result->asInt()) : result->asDouble();
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <chrono>
+#include <iostream>
+
+#include "../src/input.h"
+#include "../src/parseJSON.h"
+#include "../src/structural.h"
+
+using namespace std;
+
+/**
+ * Builds a document of at least targetSize bytes by repeating the fixture under numbered keys
+ *
+ * @param fixture JSON object used as the value of every key
+ * @param targetSize minimum size of the document in bytes
+ * @return scaled up JSON document
+ */
+string scaleDocument(const string& fixture, const size_t targetSize) {
+    string document = "{";
+    for(long long i = 0; document.size() < targetSize; i++) {
+        if(i > 0) document += ',';
+        document += "\"k" + to_string(i) + "\":" + fixture;
+    }
+    document += '}';
+    return document;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? stoull(argv[1]) : 100;
+    const unsigned threads = argc > 2 ? stoul(argv[2]) : 1;
+    const InputJSON input(string(BENCHMARK_DATA_DIR) + "/complex/everything.json");
+    const string fixture(input.view());
+    const string document = scaleDocument(fixture, megabytes * 1024 * 1024);
+
+    const auto start = chrono::steady_clock::now();
+    const auto result = parseJSON(document, threads);
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    const double size = static_cast<double>(document.size()) / (1024 * 1024);
+    cout << "parsed " << result.size() << " copies of everything.json, " << size << " MB with " << threads << " thread(s) in "
+         << elapsed.count() << " s (" << size / elapsed.count() << " MB/s)" << endl;
+
+    const auto skipStart = chrono::steady_clock::now();
+    const auto end = findContainerEnd(document, 1);
+    const chrono::duration<double> skipElapsed = chrono::steady_clock::now() - skipStart;
+    cout << "skipped " << end + 1 << " bytes in " << skipElapsed.count() << " s ("
+         << size / skipElapsed.count() << " MB/s, " << structuralInstructionSet() << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+
+#include "../src/execute.h"
+#include "../src/expression.h"
+#include "../src/input.h"
+#include "../src/parseJSON.h"
+
+using namespace std;
+
+// bytes currently allocated on the heap, each block is prefixed by its size
+atomic<size_t> liveBytes = 0;
+
+/**
+ *
+ * @param size bytes requested
+ * @param align alignment of the block, at least the size of the prefix
+ * @return the block after the prefix
+ */
+void* allocate(const size_t size, const size_t align) {
+    liveBytes.fetch_add(size, memory_order_relaxed);
+    void* memory = aligned_alloc(align, (align + size + align - 1) / align * align);
+    if(memory == nullptr) throw bad_alloc();
+    auto* block = static_cast<char*>(memory) + align;
+    memcpy(block - sizeof(size_t), &size, sizeof(size_t));
+    return block;
+}
+
+/**
+ *
+ * @param block block returned by allocate
+ * @param align alignment it was allocated with
+ */
+void deallocate(void* block, const size_t align) {
+    if(block == nullptr) return;
+    size_t size;
+    memcpy(&size, static_cast<char*>(block) - sizeof(size_t), sizeof(size_t));
+    liveBytes.fetch_sub(size, memory_order_relaxed);
+    free(static_cast<char*>(block) - align);
+}
+
+void* operator new(const size_t size) {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* memory) noexcept {
+    deallocate(memory, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    deallocate(memory, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+// memory resources allocate with an alignment
+void* operator new(const size_t size, const align_val_t alignment) {
+    return allocate(size, max(static_cast<size_t>(alignment), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}));
+}
+
+void operator delete(void* memory, const align_val_t alignment) noexcept {
+    deallocate(memory, max(static_cast<size_t>(alignment), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}));
+}
+
+void operator delete(void* memory, size_t, const align_val_t alignment) noexcept {
+    deallocate(memory, max(static_cast<size_t>(alignment), size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}));
+}
+
+/**
+ * Builds a document of at least targetSize bytes by repeating the fixture under numbered keys
+ *
+ * @param fixture JSON object used as the value of every key
+ * @param targetSize minimum size of the document in bytes
+ * @return scaled up JSON document and the number of keys
+ */
+pair<string, long long> scaleDocument(const string& fixture, const size_t targetSize) {
+    string document = "{";
+    long long keys = 0;
+    for(; document.size() < targetSize; keys++) {
+        if(keys > 0) document += ',';
+        document += "\"k" + to_string(keys) + "\":" + fixture;
+    }
+    document += '}';
+    return {document, keys};
+}
+
+/**
+ * Executes every expression on the document and prints the time it took
+ *
+ * @param name name of the measured representation
+ * @param document parsed document, object tree or tape
+ * @param expressions expressions to execute
+ */
+template<typename Document>
+void measureLookups(const string& name, const Document& document, const vector<Node>& expressions) {
+    size_t checksum = 0;
+    const auto start = chrono::steady_clock::now();
+    for(const Node& expression : expressions) {
+        checksum += toString(executeExpression(document, expression)).size();
+    }
+    const chrono::duration<double> time = chrono::steady_clock::now() - start;
+    cout << "  " << name << ": " << expressions.size() << " lookups in " << time.count()
+         << " s (checksum " << checksum << ")" << endl;
+}
+
+int main(const int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? stoull(argv[1]) : 100;
+    const size_t lookups = argc > 2 ? stoull(argv[2]) : 10000;
+    const vector<pair<string, string>> fixtures = {
+        {"everything.json", ".person.education.college.degrees[1].gpa"},
+        {"bigNoArrays.json", ".project.repository.stars"}
+    };
+    for(const auto& [fixtureName, path] : fixtures) {
+        const InputJSON input(string(BENCHMARK_DATA_DIR) + "/complex/" + fixtureName);
+        const auto [document, keys] = scaleDocument(string(input.view()), megabytes * 1024 * 1024);
+        cout << fixtureName << " scaled to " << document.size() / (1024 * 1024) << " MB" << endl;
+
+        size_t before = liveBytes.load();
+        auto start = chrono::steady_clock::now();
+        const ObjectJSON tree = parseJSON(document);
+        chrono::duration<double> time = chrono::steady_clock::now() - start;
+        cout << "  tree: " << (liveBytes.load() - before) / (1024 * 1024) << " MB, parsed in "
+             << time.count() << " s" << endl;
+
+        before = liveBytes.load();
+        start = chrono::steady_clock::now();
+        const TapeJSON tape = parseTapeJSON(document);
+        time = chrono::steady_clock::now() - start;
+        cout << "  tape: " << (liveBytes.load() - before) / (1024 * 1024) << " MB, parsed in "
+             << time.count() << " s" << endl;
+
+        // deep paths under random top-level keys
+        mt19937 random(42);
+        uniform_int_distribution<long long> key(0, keys - 1);
+        vector<Node> expressions;
+        for(size_t i = 0; i < lookups; i++) {
+            expressions.push_back(parseExpression("k" + to_string(key(random)) + path));
+        }
+        measureLookups("tree", tree, expressions);
+        measureLookups("tape", tape, expressions);
+    }
+    return 0;
+}
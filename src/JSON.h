@@ -1,33 +1,137 @@
 #ifndef JSON_H
 #define JSON_H
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include "input.h"
 #include "parseJSON.h"
+#include "snapshot.h"
 #include "value.h"
+#include "batch.h"
+#include "bytecode.h"
 #include "execute.h"
 #include "expression.h"
+#include "expressionCache.h"
+#include "simplify.h"
+
+/**
+ * How the JSON file is kept between evaluations
+ */
+enum LoadJSON {
+    EAGER,   // parsed once into a tree of values
+    LAZY,    // only loaded, each evaluation parses just the paths its expression can visit
+    TAPE,    // parsed once into a flat tape
+    SNAPSHOT // tape mapped from the snapshot next to the file, written there first if it is missing or stale
+};
 
 class JSON {
-    std::unordered_map<std::string, ValueJSON> data;
+    std::optional<DocumentJSON> document;
+    std::shared_ptr<const InputJSON> input; // raw JSON kept in lazy mode
+    std::optional<TapeJSON> tape;
+    std::unique_ptr<ExpressionCache> cache;
 
 public:
     /**
      * Constructs a JSON object with the contents of the JSON file
      * 
      * @param filePath file path of the JSON file
+     * @param load how the file is kept, LAZY is meant for evaluating one or few expressions
+     * @param threads number of threads parsing the file if EAGER
+     * @param cacheSize most compiled expressions kept for evaluating them again, 0 compiles every time
      */
-    explicit JSON(const std::string& filePath) {
-        data = parseFileJSON(filePath);
+    explicit JSON(const std::string& filePath, const LoadJSON load = EAGER, const unsigned threads = 1,
+                  const std::size_t cacheSize = EXPRESSION_CACHE_SIZE)
+        : cache(std::make_unique<ExpressionCache>(cacheSize)) {
+        switch(load) {
+            case EAGER: document.emplace(std::make_shared<const InputJSON>(filePath), threads); break;
+            case LAZY: input = std::make_shared<const InputJSON>(filePath); break;
+            case TAPE: tape.emplace(parseTapeJSON(InputJSON(filePath).view())); break;
+            case SNAPSHOT: tape.emplace(snapshotTapeJSON(filePath)); break;
+        }
     }
 
     /**
-     * 
+     * Expressions evaluated before are not parsed again, their compiled form is kept in a cache
+     *
      * @param expression expression to evaluate on the JSON this object was created with
-     * @return evaluated result
+     * @return evaluated result, a path into an eagerly parsed JSON is borrowed from this object
+     */
+    ResultJSON evaluate(const std::string& expression) const {
+        return evaluate(*cache->compile(expression));
+    }
+
+    /**
+     * Evaluates an expression compiled once, meant for evaluating the same expression many times
+     *
+     * @param program expression compiled by compileExpression
+     * @return evaluated result, a path into an eagerly parsed JSON is borrowed from this object
+     */
+    ResultJSON evaluate(const Bytecode& program) const {
+        // only the tree of values runs the bytecode, the other modes walk the kept expression
+        if(tape) return executeExpression(*tape, program.expression);
+        if(input) {
+            // the lazily parsed document is gone after the evaluation, the result is copied out of it
+            const Node& root = program.expression;
+            return ResultJSON(executeExpression(DocumentJSON(input, referencedPaths(root)).root(), root).release());
+        }
+        return executeBytecode(document->root(), program);
+    }
+
+    /**
+     * Compiles the expressions to be evaluated together, each one through the cache
+     *
+     * @param expressions expressions to evaluate on the JSON this object was created with
+     * @return batch to evaluate any number of times with evaluateMany
+     */
+    Batch compileMany(const std::vector<std::string>& expressions) const {
+        std::vector<std::shared_ptr<const Bytecode>> programs;
+        programs.reserve(expressions.size());
+        for(const std::string& expression : expressions) programs.push_back(cache->compile(expression));
+        return compileBatch(std::move(programs));
+    }
+
+    /**
+     * Evaluates the expressions together, the parts of their paths they share are looked up once.
+     * All of them are parsed first, the first one that fails to parse or evaluate throws
+     *
+     * @param expressions expressions to evaluate on the JSON this object was created with
+     * @return results in the order of the expressions, paths into an eagerly parsed JSON are borrowed from this object
+     */
+    std::vector<ResultJSON> evaluateMany(const std::vector<std::string>& expressions) const {
+        return evaluateMany(compileMany(expressions));
+    }
+
+    /**
+     * Evaluates a batch compiled once, meant for evaluating the same expressions many times
+     *
+     * @param batch expressions compiled by compileMany
+     * @return results in the order of the expressions, paths into an eagerly parsed JSON are borrowed from this object
+     */
+    std::vector<ResultJSON> evaluateMany(const Batch& batch) const {
+        if(document) return executeBatch(document->root(), batch);
+        std::vector<ResultJSON> results;
+        results.reserve(batch.programs.size());
+        if(tape) {
+            for(const auto& program : batch.programs) results.push_back(executeExpression(*tape, program->expression));
+            return results;
+        }
+        // one lazily parsed document with the paths of the whole batch, the results are copied out of it
+        std::vector<const Node*> roots;
+        roots.reserve(batch.programs.size());
+        for(const auto& program : batch.programs) roots.push_back(&program->expression);
+        const DocumentJSON lazy(input, referencedPaths(roots));
+        for(ResultJSON& result : executeBatch(lazy.root(), batch)) results.emplace_back(std::move(result).release());
+        return results;
+    }
+
+    /**
+     *
+     * @return hits and misses of the expressions evaluated so far
      */
-    ValueJSON evaluate(const std::string& expression) const {
-        return executeExpression(data, parseExpression(expression));
+    [[nodiscard]] ExpressionCache::Stats cacheStats() const {
+        return cache->stats();
     }
 };
 
@@ -0,0 +1,172 @@
+#include "batch.h"
+
+#include <map>
+#include <optional>
+#include <string_view>
+#include <tuple>
+
+using namespace std;
+
+// steps of the trie being built by parent, kind, subscript and member name
+using StepIndex = map<tuple<uint32_t, bool, long long, string_view>, uint32_t>;
+
+/**
+ *
+ * @param batch batch being compiled
+ * @param steps steps already in the trie
+ * @param parent position of the parent step
+ * @param item true for a literal subscript, false for a member
+ * @param index literal subscript
+ * @param key member name, viewing the expression of the batch
+ * @return position of the step, shared with the paths that added it before
+ */
+uint32_t addStep(Batch& batch, StepIndex& steps, const uint32_t parent, const bool item, const long long index,
+                 const string_view key) {
+    const auto [found, inserted] = steps.try_emplace({parent, item, index, key}, batch.trie.size());
+    if(inserted) batch.trie.push_back({parent, item, index, item ? KeyJSON() : KeyJSON(key)});
+    return found->second;
+}
+
+/**
+ * Follows the path down the trie as long as its subscripts are literals, adds the steps it needs
+ *
+ * @param batch batch being compiled
+ * @param steps steps already in the trie
+ * @param path IDENTIFIER, GET_MEMBER or GET_SUBSCRIPT node
+ * @param parent position of the step of the object the path starts in
+ * @return where the path ends
+ */
+PathBinding insertPath(Batch& batch, StepIndex& steps, const Node& path, const uint32_t parent) { // NOLINT(*-no-recursion)
+    uint32_t step = addStep(batch, steps, parent, false, 0, get<string>(path.value));
+    if(path.action == IDENTIFIER) return {step, nullptr};
+    if(path.action == GET_MEMBER) return insertPath(batch, steps, path.children.at(0), step);
+    for(const Node* middle = &path.children.at(0);; middle = &middle->children.at(0)) {
+        // a computed subscript and the rest of the path are executed as they are
+        if(middle->subscript->action != INT_LITERAL) return {step, middle};
+        step = addStep(batch, steps, step, true, get<long long>(middle->subscript->value), {});
+        if(middle->action == ONLY_SUBSCRIPT) return {step, nullptr};
+        if(middle->action == GET_MEMBER) return insertPath(batch, steps, middle->children.at(0), step);
+    }
+}
+
+/**
+ * Adds the paths of the expression to the trie
+ *
+ * @param batch batch being compiled
+ * @param steps steps already in the trie
+ * @param expression expression executed on the entire JSON
+ */
+void insertPaths(Batch& batch, StepIndex& steps, const Node& expression) { // NOLINT(*-no-recursion)
+    switch(expression.action) {
+        case IDENTIFIER:
+        case GET_MEMBER:
+        case GET_SUBSCRIPT:
+            batch.bindings.emplace(&expression, insertPath(batch, steps, expression, 0));
+            return;
+        case INT_LITERAL:
+        case FLOAT_LITERAL:
+        case ONLY_SUBSCRIPT:
+            return;
+        default:
+            for(const Node& child : expression.children) insertPaths(batch, steps, child);
+    }
+}
+
+Batch compileBatch(vector<shared_ptr<const Bytecode>> programs) {
+    Batch batch;
+    batch.programs = std::move(programs);
+    batch.trie.push_back({0, false, 0, {}});
+    StepIndex steps;
+    for(const auto& program : batch.programs) insertPaths(batch, steps, program->expression);
+    return batch;
+}
+
+/**
+ * Value a step of the trie stands for in one execution of the batch
+ */
+struct ResolvedStep {
+    const ValueJSON* value = nullptr; // nullptr if there is no such path in the JSON
+    ValueJSON number; // item of a column of numbers, value points here
+};
+
+/**
+ *
+ * @param JSON entire JSON object
+ * @param expression expression to execute
+ * @param batch batch the expression is part of
+ * @param resolved values of the steps of the trie
+ * @return evaluated expression, nothing if a path failed and the expression has to be executed on its own
+ */
+optional<ResultJSON> executeBound(const ObjectJSON& JSON, const Node& expression, const Batch& batch, // NOLINT(*-no-recursion)
+                                  const vector<ResolvedStep>& resolved) {
+    switch(expression.action) {
+        case IDENTIFIER:
+        case GET_MEMBER:
+        case GET_SUBSCRIPT: {
+            const auto& [step, rest] = batch.bindings.at(&expression);
+            const ResolvedStep& end = resolved[step];
+            if(end.value == nullptr) return nullopt;
+            if(rest == nullptr) {
+                // numbers of columns only live as long as the execution, they are copied
+                if(end.value == &end.number) return ResultJSON(end.number);
+                return ResultJSON::borrow(*end.value);
+            }
+            if(end.value->type != ARRAY) return nullopt;
+            try {
+                return getItemFromArray(JSON, *rest, end.value->asArray());
+            } catch (const pathException&) {
+                return nullopt;
+            }
+        }
+        case INT_LITERAL: return ResultJSON(ValueJSON(get<long long>(expression.value)));
+        case FLOAT_LITERAL: return ResultJSON(ValueJSON(get<double>(expression.value)));
+        case ONLY_SUBSCRIPT: return nullopt;
+        default: break;
+    }
+    vector<ResultJSON> arguments;
+    arguments.reserve(expression.children.size());
+    for(const Node& child : expression.children) {
+        optional<ResultJSON> argument = executeBound(JSON, child, batch, resolved);
+        if(!argument) return nullopt;
+        arguments.push_back(std::move(*argument));
+    }
+    return ResultJSON(applyAction(expression.action, arguments));
+}
+
+vector<ResultJSON> executeBatch(const ObjectJSON& JSON, const Batch& batch) {
+    // parents come first, one pass looks up every step once
+    vector<ResolvedStep> resolved(batch.trie.size());
+    for(size_t i = 1; i < batch.trie.size(); i++) {
+        const TrieStep& step = batch.trie[i];
+        const ObjectJSON* object = &JSON;
+        const ArrayJSON* array = nullptr;
+        if(step.parent != 0) {
+            const ValueJSON* parent = resolved[step.parent].value;
+            if(parent == nullptr) continue;
+            object = parent->type == OBJECT ? &parent->asObject() : nullptr;
+            array = parent->type == ARRAY ? &parent->asArray() : nullptr;
+        }
+        ResolvedStep& current = resolved[i];
+        if(!step.item) {
+            if(object == nullptr) continue;
+            if(const auto member = object->find(step.key); member != object->end()) current.value = &member->second;
+        } else if(array != nullptr && step.index >= 0 && static_cast<size_t>(step.index) < array->size()) {
+            if(array->column() != typeNULL) {
+                current.number = array->item(step.index);
+                current.value = &current.number;
+            } else {
+                current.value = &array->at(step.index);
+            }
+        }
+    }
+
+    vector<ResultJSON> results;
+    results.reserve(batch.programs.size());
+    for(const auto& program : batch.programs) {
+        optional<ResultJSON> result = executeBound(JSON, program->expression, batch, resolved);
+        // executed again on its own, it throws the exception of the path that failed
+        if(!result) result = executeExpression(JSON, program->expression);
+        results.push_back(std::move(*result));
+    }
+    return results;
+}
@@ -0,0 +1,60 @@
+#ifndef BATCH_H
+#define BATCH_H
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "bytecode.h"
+#include "execute.h"
+#include "expression.h"
+#include "value.h"
+
+/**
+ * Node of the trie of the paths of a batch, one member or literal subscript below its parent
+ */
+struct TrieStep {
+    uint32_t parent; // position of the parent in the trie
+    bool item; // literal subscript, member otherwise
+    long long index;
+    KeyJSON key;
+};
+
+/**
+ * Where a path of the batch ends in the trie
+ */
+struct PathBinding {
+    uint32_t step; // position in the trie
+    const Node* rest; // intermediary array node of a computed subscript the path goes on with, nullptr if it ends at step
+};
+
+/**
+ * Expressions compiled to be evaluated together. The paths of all of them are merged into a trie
+ * of member names and literal subscripts, shared prefixes are one node of the trie
+ */
+struct Batch {
+    std::vector<std::shared_ptr<const Bytecode>> programs;
+    std::vector<TrieStep> trie; // parents come before their children, the first step is the entire JSON
+    std::unordered_map<const Node*, PathBinding> bindings; // path nodes of the expressions
+};
+
+/**
+ * Merges the paths of the expressions into a trie, follows each path as long as its subscripts are literals
+ *
+ * @param programs compiled expressions, kept by the batch
+ * @return batch to evaluate any number of times
+ */
+Batch compileBatch(std::vector<std::shared_ptr<const Bytecode>> programs);
+
+/**
+ * Executes the batch, every step of the trie is looked up once and a path then takes the value of the step it ends at.
+ * Paths go on past a computed subscript on their own.
+ * An expression that fails throws the same exception as executeExpression, the first failing one in order
+ *
+ * @param JSON entire JSON object
+ * @param batch compiled batch
+ * @return results in the order of the expressions, borrowed from JSON where they are values of it
+ */
+std::vector<ResultJSON> executeBatch(const ObjectJSON& JSON, const Batch& batch);
+
+#endif //BATCH_H
@@ -0,0 +1,211 @@
+#include "bytecode.h"
+
+#include <array>
+#include <memory_resource>
+
+#include "simplify.h"
+
+using namespace std;
+
+/**
+ * Appends the instruction and keeps track of how deep the stack gets
+ *
+ * @param program program being compiled
+ * @param instruction instruction to append
+ * @param depth values on the stack before the instruction, updated to after it
+ */
+void emit(Bytecode& program, const Instruction instruction, size_t& depth) {
+    switch(instruction.code) {
+        case PUSH_CONSTANT:
+        case ROOT_MEMBER: depth++; break;
+        case MEMBER: break;
+        case INDEX: depth--; break;
+        case APPLY: depth = depth - instruction.operand + 1; break;
+    }
+    program.stackSize = max(program.stackSize, depth);
+    program.code.push_back(instruction);
+}
+
+/**
+ *
+ * @param program program being compiled
+ * @param key key of the member, resolved with its hash
+ * @return operand of the key
+ */
+uint32_t addKey(Bytecode& program, const string& key) {
+    program.keys.emplace_back(key);
+    return static_cast<uint32_t>(program.keys.size() - 1);
+}
+
+void compileNode(Bytecode& program, const Node& node, size_t& depth);
+
+void compileSubscript(Bytecode& program, const Node& middle, size_t& depth);
+
+/**
+ * Compiles a path, each step looks up a member of the value on top
+ *
+ * @param program program being compiled
+ * @param node IDENTIFIER, GET_MEMBER or GET_SUBSCRIPT node
+ * @param code ROOT_MEMBER for the first step of the path, MEMBER for the others
+ * @param depth values on the stack
+ */
+void compilePath(Bytecode& program, const Node& node, const OpCode code, size_t& depth) { // NOLINT(*-no-recursion)
+    const uint32_t key = addKey(program, get<string>(node.value));
+    switch(node.action) {
+        case IDENTIFIER:
+            emit(program, {code, typeNULL, IDENTIFIER, key}, depth);
+            return;
+        case GET_MEMBER:
+            emit(program, {code, OBJECT, IDENTIFIER, key}, depth);
+            compilePath(program, node.children.at(0), MEMBER, depth);
+            return;
+        case GET_SUBSCRIPT:
+            emit(program, {code, ARRAY, IDENTIFIER, key}, depth);
+            compileSubscript(program, node.children.at(0), depth);
+            return;
+        default: throw executeException("Unexpected action");
+    }
+}
+
+/**
+ * Compiles the subscript of an array, it is evaluated from the entire JSON, and the rest of the path
+ *
+ * @param program program being compiled
+ * @param middle intermediary array node
+ * @param depth values on the stack
+ */
+void compileSubscript(Bytecode& program, const Node& middle, size_t& depth) { // NOLINT(*-no-recursion)
+    compileNode(program, *middle.subscript, depth);
+    switch(middle.action) {
+        case ONLY_SUBSCRIPT:
+            emit(program, {INDEX}, depth);
+            return;
+        case GET_MEMBER:
+            emit(program, {INDEX, OBJECT}, depth);
+            compilePath(program, middle.children.at(0), MEMBER, depth);
+            return;
+        case GET_SUBSCRIPT:
+            emit(program, {INDEX, ARRAY}, depth);
+            compileSubscript(program, middle.children.at(0), depth);
+            return;
+        default: throw executeException("Unexpected action");
+    }
+}
+
+/**
+ *
+ * @param program program being compiled
+ * @param node expression evaluated from the entire JSON
+ * @param depth values on the stack
+ */
+void compileNode(Bytecode& program, const Node& node, size_t& depth) { // NOLINT(*-no-recursion)
+    switch(node.action) {
+        case IDENTIFIER:
+        case GET_MEMBER:
+        case GET_SUBSCRIPT:
+            compilePath(program, node, ROOT_MEMBER, depth);
+            return;
+        case INT_LITERAL:
+            program.constants.emplace_back(get<long long>(node.value));
+            emit(program, {PUSH_CONSTANT, typeNULL, IDENTIFIER, static_cast<uint32_t>(program.constants.size() - 1)}, depth);
+            return;
+        case FLOAT_LITERAL:
+            program.constants.emplace_back(get<double>(node.value));
+            emit(program, {PUSH_CONSTANT, typeNULL, IDENTIFIER, static_cast<uint32_t>(program.constants.size() - 1)}, depth);
+            return;
+        case ONLY_SUBSCRIPT:
+            throw executeException("Grave error, switch case ONLY_SUBSCRIPT should be impossible!");
+        case MAX:
+        case MIN:
+        case SIZE:
+        case SUM:
+        case AVG:
+        case COUNT:
+        case STDDEV:
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE:
+            for(const Node& child : node.children) compileNode(program, child, depth);
+            emit(program, {APPLY, typeNULL, node.action, static_cast<uint32_t>(node.children.size())}, depth);
+            return;
+    }
+    throw executeException("Grave error, switch case leaked!");
+}
+
+Bytecode compileExpression(Node expression) {
+    Bytecode program(simplifyExpression(std::move(expression)));
+    size_t depth = 0;
+    compileNode(program, program.expression, depth);
+    return program;
+}
+
+/**
+ *
+ * @param value value pushed by a path step
+ * @param expect type the path needs, typeNULL for any
+ * @return whether the path can go on with the value
+ */
+inline bool expected(const ValueJSON& value, const TypeJSON expect) {
+    return expect == typeNULL || value.type == expect;
+}
+
+// values the stack holds without allocating, deeper expressions allocate the rest
+constexpr size_t INLINE_STACK = 16;
+
+ResultJSON executeBytecode(const ObjectJSON& JSON, const Bytecode& program) {
+    array<byte, INLINE_STACK * sizeof(ResultJSON)> buffer; // NOLINT(*-pro-type-member-init)
+    pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+    pmr::vector<ResultJSON> stack(&resource);
+    stack.reserve(program.stackSize);
+
+    for(const Instruction& instruction : program.code) {
+        switch(instruction.code) {
+            case PUSH_CONSTANT:
+                // constants are numbers, copying them allocates nothing and the result may outlive the program
+                stack.emplace_back(program.constants[instruction.operand]);
+                break;
+            case ROOT_MEMBER: {
+                const auto member = JSON.find(program.keys[instruction.operand]);
+                if(member == JSON.end() || !expected(member->second, instruction.expect))
+                    return executeExpression(JSON, program.expression);
+                stack.push_back(ResultJSON::borrow(member->second));
+                break;
+            }
+            case MEMBER: {
+                const ObjectJSON& object = stack.back()->asObject();
+                const auto member = object.find(program.keys[instruction.operand]);
+                if(member == object.end() || !expected(member->second, instruction.expect))
+                    return executeExpression(JSON, program.expression);
+                stack.back() = ResultJSON::borrow(member->second);
+                break;
+            }
+            case INDEX: {
+                if(stack.back()->type != INT) return executeExpression(JSON, program.expression);
+                const long long index = stack.back()->asInt();
+                stack.pop_back();
+                const ArrayJSON& array = stack.back()->asArray();
+                if(index < 0 || index >= static_cast<long long>(array.size())) return executeExpression(JSON, program.expression);
+                if(array.column() != typeNULL) {
+                    // the numbers of a column are made into values, they allocate nothing
+                    if(instruction.expect != typeNULL) return executeExpression(JSON, program.expression);
+                    stack.back() = ResultJSON(array.item(index));
+                    break;
+                }
+                const ValueJSON& item = array.at(index);
+                if(!expected(item, instruction.expect)) return executeExpression(JSON, program.expression);
+                stack.back() = ResultJSON::borrow(item);
+                break;
+            }
+            case APPLY: {
+                const auto arguments = span<const ResultJSON>(stack).last(instruction.operand);
+                ResultJSON result(applyAction(instruction.action, arguments));
+                stack.erase(stack.end() - instruction.operand, stack.end());
+                stack.push_back(std::move(result));
+                break;
+            }
+        }
+    }
+    return std::move(stack.back());
+}
@@ -0,0 +1,63 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "execute.h"
+#include "expression.h"
+#include "value.h"
+
+/**
+ * Instructions of the bytecode, each one pops its inputs off the value stack and pushes its result
+ */
+enum OpCode : uint8_t {
+    PUSH_CONSTANT, // pushes constants[operand]
+    ROOT_MEMBER,   // pushes the member keys[operand] of the entire JSON
+    MEMBER,        // replaces the object on top with its member keys[operand]
+    INDEX,         // pops the subscript, replaces the array below it with its item
+    APPLY          // replaces the top operand values with the result of the function or operator
+};
+
+struct Instruction {
+    OpCode code;
+    TypeJSON expect = typeNULL; // type the pushed value must have for the path to go on, typeNULL for any
+    NodeAction action = IDENTIFIER; // function or operator of APPLY
+    uint32_t operand = 0; // key, constant or argument count
+};
+
+/**
+ * Expression compiled into a linear program for a stack machine.
+ * Keys are resolved once, with their hashes, when the expression is compiled.
+ * The expression is kept to report a failing path exactly like the tree walk does
+ */
+struct Bytecode {
+    std::vector<Instruction> code;
+    std::vector<KeyJSON> keys;
+    std::vector<ValueJSON> constants;
+    std::size_t stackSize = 0; // most values on the stack at once
+    Node expression;
+
+    explicit Bytecode(Node expression)
+        : expression(std::move(expression)) {}
+};
+
+/**
+ * Compiles the simplified expression tree into bytecode, functions and operators come after their arguments
+ *
+ * @param expression expression to compile, parsed by parseExpression
+ * @return program evaluating the expression
+ */
+Bytecode compileExpression(Node expression);
+
+/**
+ * Runs the bytecode with an interpreter loop over a value stack.
+ * A path that fails is executed again by the tree walk so the exception is the same
+ *
+ * @param JSON entire JSON object
+ * @param program compiled expression
+ * @return evaluated expression on JSON, borrowed from it if it is a value of the JSON
+ */
+ResultJSON executeBytecode(const ObjectJSON& JSON, const Bytecode& program);
+
+#endif //BYTECODE_H
@@ -1,7 +1,10 @@
 #include "execute.h"
 
-#include <cfloat>
+#include <algorithm>
 #include <cmath>
+#include <optional>
+
+#include "numeric.h"
 
 using namespace std;
 
@@ -12,8 +15,8 @@ using namespace std;
  * @param currentObj current object function is in
  * @return evaluated expression on currentObj
  */
-ValueJSON executeExpression(const unordered_map<string, ValueJSON> &JSON, const Node &expression,
-                            const unordered_map<string, ValueJSON> &currentObj);
+ResultJSON executeExpression(const ObjectJSON& JSON, const Node &expression,
+                             const ObjectJSON& currentObj);
 
 /**
  *
@@ -21,7 +24,7 @@ ValueJSON executeExpression(const unordered_map<string, ValueJSON> &JSON, const
  * @param expression expression to execute
  * @return evaluated expression on JSON
  */
-ValueJSON executeExpression(const unordered_map<string, ValueJSON>& JSON, const Node& expression) { // NOLINT(*-no-recursion)
+ResultJSON executeExpression(const ObjectJSON& JSON, const Node& expression) { // NOLINT(*-no-recursion)
     return executeExpression(JSON, expression, JSON);
 }
 
@@ -32,10 +35,10 @@ ValueJSON executeExpression(const unordered_map<string, ValueJSON>& JSON, const
  * @param array array of ValueJSONs to pick from
  * @return evaluated subscript expression
  */
-ValueJSON getItemFromArray(const unordered_map<string, ValueJSON> &JSON, const Node &expression, // NOLINT(*-no-recursion)
-                           const vector<ValueJSON> &array) {
+ResultJSON getItemFromArray(const ObjectJSON& JSON, const Node &expression, // NOLINT(*-no-recursion)
+                            const ArrayJSON& array) {
 
-    ValueJSON sub;
+    ResultJSON sub;
     try {
         sub = executeExpression(JSON, *expression.subscript);
     } catch (pathException& e) {
@@ -44,18 +47,23 @@ ValueJSON getItemFromArray(const unordered_map<string, ValueJSON> &JSON, const N
         throw;
     }
 
-    if(sub.type != INT) throw pathException("Subscript should be an integer", "");
-    const long long index = get<long long>(sub.value);
-    if(index < 0 || index > array.size())
+    if(sub->type != INT) throw pathException("Subscript should be an integer", "");
+    const long long index = sub->asInt();
+    if(index < 0 || static_cast<size_t>(index) >= array.size())
         throw pathException("Index was out of bounds for array of size " + to_string(array.size()), '[' + to_string(index) + ']');
-    ValueJSON arrayItem = array.at(index);
-    if(expression.action == ONLY_SUBSCRIPT) return arrayItem;
+    if(expression.action == ONLY_SUBSCRIPT) {
+        // the numbers of a column are made into values, they allocate nothing
+        if(array.column() != typeNULL) return ResultJSON(array.item(index));
+        return ResultJSON::borrow(array.at(index));
+    }
+    // the items of a column are bare numbers, one is made into a value only to fail the path below
+    const ValueJSON number = array.column() != typeNULL ? array.item(index) : ValueJSON();
+    const ValueJSON& arrayItem = array.column() != typeNULL ? number : array.at(index);
     const auto& next = expression.children.at(0);
     if(expression.action == GET_MEMBER) {
         if(arrayItem.type != OBJECT) throw pathException("This path should be an object", '[' + to_string(index) + ']');
-        const unordered_map<string, ValueJSON> obj = get<unordered_map<string, ValueJSON>>(arrayItem.value);
         try {
-            return executeExpression(JSON, next, obj);
+            return executeExpression(JSON, next, arrayItem.asObject());
         } catch (pathException& e) {
             e.appendPathFront('[' + to_string(index) + ']');
             throw;
@@ -64,7 +72,7 @@ ValueJSON getItemFromArray(const unordered_map<string, ValueJSON> &JSON, const N
     if(expression.action == GET_SUBSCRIPT) {
         if(arrayItem.type != ARRAY) throw pathException("This path should be an array", '[' + to_string(index) + ']');
         try {
-            return getItemFromArray(JSON, next, get<vector<ValueJSON>>(arrayItem.value));
+            return getItemFromArray(JSON, next, arrayItem.asArray());
         } catch (pathException& e) {
             e.appendPathFront('[' + to_string(index) + ']');
             throw;
@@ -82,131 +90,304 @@ ValueJSON getItemFromArray(const unordered_map<string, ValueJSON> &JSON, const N
  */
 inline double extractDouble(const ValueJSON& number) {
     if(number.type == INT)
-        return static_cast<double>(get<long long>(number.value));
+        return static_cast<double>(number.asInt());
     else if(number.type == FLOAT)
-        return get<double>(number.value);
+        return number.asDouble();
     throw executeException("Unexpected type in extractDouble");
 }
 
 /**
- * Returns maximum value, integer if all arguments are also integers, floating point number otherwise
+ * Raises an integer to a non-negative integer power by squaring, exact unlike pow beyond 2^53
  *
- * @param JSON entire JSON object
- * @param expression max function node
- * @return evaluated max function on JSON
+ * @param base integer base
+ * @param exponent integer exponent
+ * @return power, nothing if the exponent is negative or the power overflows
  */
-ValueJSON getMax(const unordered_map<string, ValueJSON> &JSON, const Node &expression) { // NOLINT(*-no-recursion)
-    vector<ValueJSON> arguments;
-    for(const Node& child : expression.children) {
-        arguments.push_back(executeExpression(JSON, child));
+optional<long long> integerPower(long long base, long long exponent) {
+    if(exponent < 0) return nullopt;
+    long long power = 1;
+    while(exponent > 0) {
+        if((exponent & 1) != 0 && __builtin_mul_overflow(power, base, &power)) return nullopt;
+        exponent >>= 1;
+        if(exponent > 0 && __builtin_mul_overflow(base, base, &base)) return nullopt;
     }
-    vector<ValueJSON> values;
-    string exceptionMessage = "Arguments should only be numbers in max function";
-    if(arguments.size() == 1 && arguments.at(0).type == ARRAY) {
-        values = get<vector<ValueJSON>>(arguments.at(0).value);
-        if(values.empty()) throw executeException("Array should not be empty in max function");
-        exceptionMessage = "Array should only contain numbers in max function";
+    return power;
+}
 
-    } else {
-        values = arguments;
-        exceptionMessage = "Arguments should only be numbers in max function";
-    }
+/**
+ *
+ * @param value value
+ * @return the value
+ */
+inline const ValueJSON& valueOf(const ValueJSON& value) {
+    return value;
+}
 
-    bool onlyIntegers = true;
-    for(const ValueJSON& child : values) {
-        if(child.type != INT && child.type != FLOAT) throw executeException(exceptionMessage);
-        if(child.type != INT) onlyIntegers = false;
-    }
-    if(onlyIntegers) {
-        long long result = INT_MIN;
-        for(const ValueJSON& child : values) {
-            result = max(result, get<long long>(child.value));
-        }
-        return {INT, result};
-    } else {
-        double result = -DBL_MAX;
-        for(const ValueJSON& child : values) {
-            result = max(result, extractDouble(child));
+/**
+ *
+ * @param result result
+ * @return the value of the result
+ */
+inline const ValueJSON& valueOf(const ResultJSON& result) {
+    return *result;
+}
+
+/**
+ * Smallest or largest of the numbers in one pass that checks their types on the way,
+ * integer if all of them are integers, floating point number otherwise
+ *
+ * @param values items of an array or arguments of the function
+ * @param largest true for the largest, false for the smallest
+ * @param array true if the values are items of an array, for the message of the exception
+ * @return smallest or largest number
+ */
+template<typename Values>
+ValueJSON extremeOfValues(const Values& values, const bool largest, const bool array) {
+    long long integer = 0;
+    double floating = 0;
+    bool anyInteger = false, anyFloat = false;
+    for(const auto& item : values) {
+        const ValueJSON& value = valueOf(item);
+        if(value.type == INT) {
+            const long long number = value.asInt();
+            integer = !anyInteger ? number : largest ? max(integer, number) : min(integer, number);
+            anyInteger = true;
+        } else if(value.type == FLOAT) {
+            const double number = value.asDouble();
+            floating = !anyFloat ? number : largest ? max(floating, number) : min(floating, number);
+            anyFloat = true;
+        } else {
+            throw executeException(string(array ? "Array should only contain numbers" : "Arguments should only be numbers")
+                                   + " in " + (largest ? "max" : "min") + " function");
         }
-        return {FLOAT, result};
     }
+    if(!anyFloat) return ValueJSON(integer);
+    if(!anyInteger) return ValueJSON(floating);
+    // converting to double keeps the order, the extreme integer stands for all of them
+    const auto converted = static_cast<double>(integer);
+    return ValueJSON(largest ? max(floating, converted) : min(floating, converted));
 }
 
 /**
- * Returns minimum value, integer if all arguments are also integers, floating point number otherwise
+ * Smallest or largest number of the arguments, or of the items of an array if it is the only argument
  *
- * @param JSON entire JSON object
- * @param expression min function node
- * @return evaluated min function on JSON
+ * @param arguments evaluated arguments of the min or max function
+ * @param largest true for max, false for min
+ * @return evaluated min or max function
  */
-ValueJSON getMin(const unordered_map<string, ValueJSON> &JSON, const Node &expression) { // NOLINT(*-no-recursion)
-    vector<ValueJSON> arguments;
-    for(const Node& child : expression.children) {
-        arguments.push_back(executeExpression(JSON, child));
+ValueJSON getExtreme(const span<const ResultJSON> arguments, const bool largest) {
+    const string_view function = largest ? "max" : "min";
+    if(arguments.empty()) throw executeException("Arguments should not be empty in " + string(function) + " function");
+    if(arguments.size() == 1 && arguments[0]->type == ARRAY) {
+        const ArrayJSON& array = arguments[0]->asArray();
+        if(array.empty()) throw executeException("Array should not be empty in " + string(function) + " function");
+        // columns hold numbers of one type only, they are reduced without checks by the vectorized kernels
+        if(array.column() == INT) return ValueJSON(findExtreme(array.integers(), largest));
+        if(array.column() == FLOAT) return ValueJSON(findExtreme(array.floats(), largest));
+        return extremeOfValues(array.values(), largest, true);
     }
-    vector<ValueJSON> values;
-    string exceptionMessage = "Arguments should only be numbers in min function";
-    if(arguments.size() == 1 && arguments.at(0).type == ARRAY) {
-        values = get<vector<ValueJSON>>(arguments.at(0).value);
-        if(values.empty()) throw executeException("Array should not be empty in min function");
-        exceptionMessage = "Array should only contain numbers in min function";
+    return extremeOfValues(arguments, largest, false);
+}
 
-    } else {
-        values = arguments;
-        exceptionMessage = "Arguments should only be numbers in min function";
+/**
+ * Sum, count, mean and spread of numbers gathered in one pass
+ */
+struct Aggregate {
+    long long count = 0;
+    long long integers = 0; // exact sum of the integers as long as it fits
+    CompensatedSum floats; // sum of the floating point numbers and of integer sums that overflowed
+    bool onlyIntegers = true;
+    bool deviation = false; // whether to keep the running mean and squares, only stddev needs them
+    double mean = 0;
+    double squares = 0; // sum of squared deviations from the running mean (Welford)
+
+    /**
+     *
+     * @param number integer to add
+     */
+    void add(const long long number) {
+        long long total;
+        if(__builtin_add_overflow(integers, number, &total)) {
+            floats.add(static_cast<double>(integers));
+            total = number;
+            onlyIntegers = false;
+        }
+        integers = total;
+        count++;
+        if(deviation) spread(static_cast<double>(number));
     }
 
-    // validate if all values are numbers and at the same time check if there are only integers
-    bool onlyIntegers = true;
-    for(const ValueJSON& child : values) {
-        if(child.type != INT && child.type != FLOAT) throw executeException(exceptionMessage);
-        if(child.type != INT) onlyIntegers = false;
+    /**
+     *
+     * @param number floating point number to add
+     */
+    void add(const double number) {
+        floats.add(number);
+        onlyIntegers = false;
+        count++;
+        if(deviation) spread(number);
     }
-    if(onlyIntegers) {
-        long long result = INT_MAX;
-        for(const ValueJSON& child : values) {
-            result = min(result, get<long long>(child.value));
-        }
-        return {INT, result};
-    } else {
-        double result = DBL_MAX;
-        for(const ValueJSON& child : values) {
-            result = min(result, extractDouble(child));
+
+    /**
+     * Updates the running mean and squares
+     *
+     * @param number number added
+     */
+    void spread(const double number) {
+        const double delta = number - mean;
+        mean += delta / static_cast<double>(count);
+        squares += delta * (number - mean);
+    }
+
+    /**
+     *
+     * @return sum of all numbers, integer if all of them are integers and their sum fits
+     */
+    [[nodiscard]] ValueJSON sum() const {
+        if(onlyIntegers) return ValueJSON(integers);
+        CompensatedSum total = floats;
+        total.add(static_cast<double>(integers));
+        return ValueJSON(total.value());
+    }
+};
+
+/**
+ *
+ * @param action SUM, AVG, COUNT or STDDEV
+ * @return name of the function
+ */
+const char* aggregateName(const NodeAction action) {
+    switch(action) {
+        case SUM: return "sum";
+        case AVG: return "avg";
+        case COUNT: return "count";
+        default: return "stddev";
+    }
+}
+
+/**
+ * Adds the numbers to the aggregate, count skips what isn't a number and the others throw
+ *
+ * @param aggregate aggregate to add to
+ * @param values items of an array or arguments of the function
+ * @param action SUM, AVG, COUNT or STDDEV
+ * @param array true if the values are items of an array, for the message of the exception
+ */
+template<typename Values>
+void aggregateValues(Aggregate& aggregate, const Values& values, const NodeAction action, const bool array) {
+    for(const auto& item : values) {
+        const ValueJSON& value = valueOf(item);
+        if(value.type == INT) aggregate.add(value.asInt());
+        else if(value.type == FLOAT) aggregate.add(value.asDouble());
+        else if(action != COUNT) {
+            throw executeException(string(array ? "Array should only contain numbers" : "Arguments should only be numbers")
+                                   + " in " + aggregateName(action) + " function");
         }
-        return {FLOAT, result};
     }
 }
 
 /**
+ * Sum, mean, count of numbers or population standard deviation of the arguments,
+ * or of the items of an array if it is the only argument
  *
- * @param JSON entire JSON object
- * @param expression size function node
- * @return evaluated size function on JSON
+ * @param action SUM, AVG, COUNT or STDDEV
+ * @param arguments evaluated arguments of the function
+ * @return evaluated function
  */
-ValueJSON getSize(const unordered_map<string, ValueJSON> &JSON, const Node &expression) { // NOLINT(*-no-recursion)
-    vector<ValueJSON> arguments;
-    for(const Node& child : expression.children) {
-        arguments.push_back(executeExpression(JSON, child));
+ValueJSON getAggregate(const NodeAction action, const span<const ResultJSON> arguments) {
+    if(arguments.empty()) throw executeException("Arguments should not be empty in " + string(aggregateName(action)) + " function");
+    Aggregate aggregate;
+    aggregate.deviation = action == STDDEV;
+    const bool array = arguments.size() == 1 && arguments[0]->type == ARRAY;
+    if(array) {
+        // columns are read as the bare numbers, nothing is made into a value
+        const ArrayJSON& items = arguments[0]->asArray();
+        if(items.column() == INT) for(const long long number : items.integers()) aggregate.add(number);
+        else if(items.column() == FLOAT) for(const double number : items.floats()) aggregate.add(number);
+        else aggregateValues(aggregate, items.values(), action, true);
+    } else {
+        aggregateValues(aggregate, arguments, action, false);
     }
+
+    if(action == COUNT) return ValueJSON(aggregate.count);
+    if(action == SUM) return aggregate.sum();
+    if(aggregate.count == 0) throw executeException("Array should not be empty in " + string(aggregateName(action)) + " function");
+    if(action == AVG) return ValueJSON(extractDouble(aggregate.sum()) / static_cast<double>(aggregate.count));
+    return ValueJSON(sqrt(aggregate.squares / static_cast<double>(aggregate.count)));
+}
+
+/**
+ *
+ * @param arguments evaluated arguments of the size function
+ * @return evaluated size function
+ */
+ValueJSON getSize(const span<const ResultJSON> arguments) {
     if(arguments.size() != 1) throw executeException("Size function can only have one argument");
-    switch(const ValueJSON& argument = arguments.at(0); argument.type) {
-        case STRING: return {INT, static_cast<long long>(get<string>(argument.value).size())};
-        case ARRAY: return {INT, static_cast<long long>(get<vector<ValueJSON>>(argument.value).size())};
-        case OBJECT: return {INT, static_cast<long long>(get<unordered_map<string, ValueJSON>>(argument.value).size())};
+    switch(const ValueJSON& argument = *arguments[0]; argument.type) {
+        case STRING: return ValueJSON(static_cast<long long>(argument.asString().size()));
+        case ARRAY: return ValueJSON(static_cast<long long>(argument.asArray().size()));
+        case OBJECT: return ValueJSON(static_cast<long long>(argument.asObject().size()));
         default: throw executeException("Wrong type for size function");
     }
 }
 
-inline pair<ValueJSON, ValueJSON> getOperands(const unordered_map<string, ValueJSON>& JSON, const Node& expression) {
-    if(expression.children.size() != 2) throw executeException("Wrong number of operands for a binary operator");
-    ValueJSON a = executeExpression(JSON, expression.children.at(0));
-    ValueJSON b = executeExpression(JSON, expression.children.at(1));
-    return {a, b};
+ValueJSON applyAction(const NodeAction action, const span<const ResultJSON> arguments) {
+    switch(action) {
+        case MAX: return getExtreme(arguments, true);
+        case MIN: return getExtreme(arguments, false);
+        case SUM:
+        case AVG:
+        case COUNT:
+        case STDDEV: return getAggregate(action, arguments);
+        case SIZE: return getSize(arguments);
+        default: break;
+    }
+    if(arguments.size() != 2) throw executeException("Wrong number of operands for a binary operator");
+    const ValueJSON& a = *arguments[0];
+    const ValueJSON& b = *arguments[1];
+    const bool integers = a.type == INT && b.type == INT;
+    switch(action) {
+        case ADD:
+            if(integers) return ValueJSON(a.asInt() + b.asInt());
+            return ValueJSON(extractDouble(a) + extractDouble(b));
+        case SUBTRACT:
+            if(integers) return ValueJSON(a.asInt() - b.asInt());
+            return ValueJSON(extractDouble(a) - extractDouble(b));
+        case MULTIPLY:
+            if(integers) return ValueJSON(a.asInt() * b.asInt());
+            return ValueJSON(extractDouble(a) * extractDouble(b));
+        case DIVIDE:
+            if(integers) return ValueJSON(a.asInt() / b.asInt());
+            return ValueJSON(extractDouble(a) / extractDouble(b));
+        case RAISE:
+            if(integers) {
+                if(const auto power = integerPower(a.asInt(), b.asInt())) return ValueJSON(*power);
+                return ValueJSON(static_cast<long long>(llround(pow(a.asInt(), b.asInt()))));
+            }
+            return ValueJSON(pow(extractDouble(a), extractDouble(b)));
+        default: throw executeException("Grave error, not a function or operator!");
+    }
+}
+
+/**
+ *
+ * @param JSON entire JSON, object tree or tape
+ * @param expression function or operator node
+ * @return its children evaluated on the entire JSON, paths are borrowed from it
+ */
+template<typename Document>
+vector<ResultJSON> executeArguments(const Document& JSON, const Node& expression) { // NOLINT(*-no-recursion)
+    vector<ResultJSON> arguments;
+    arguments.reserve(expression.children.size());
+    for(const Node& child : expression.children) {
+        arguments.push_back(executeExpression(JSON, child));
+    }
+    return arguments;
 }
 
 /**
  *TODO refactor Node struct by making it class with a method
- * execute(const unordered_map<string, ValueJSON>& JSON, const unordered_map<string, ValueJSON>& currentObj)
+ * execute(const ObjectJSON& JSON, const ObjectJSON& currentObj)
  * with intrinsic functions and binary operators as abstract subtypes of Node
  * and make a subtype for each action of NodeAction
  * then move each case from this method to the corresponding class
@@ -218,28 +399,29 @@ inline pair<ValueJSON, ValueJSON> getOperands(const unordered_map<string, ValueJ
  * @param currentObj current object function is in
  * @return evaluated expression on currentObj
  */
-ValueJSON executeExpression(const unordered_map<string, ValueJSON>& JSON, const Node& expression, // NOLINT(*-no-recursion)
-    const unordered_map<string, ValueJSON>& currentObj) {
+ResultJSON executeExpression(const ObjectJSON& JSON, const Node& expression, // NOLINT(*-no-recursion)
+    const ObjectJSON& currentObj) {
     switch (expression.action) {
         case IDENTIFIER: {
             const auto& identifier = get<string>(expression.value);
-            if(!currentObj.contains(identifier)) throw pathException("No such key in JSON", identifier);
-            return currentObj.at(identifier);
+            const auto member = currentObj.find(identifier);
+            if(member == currentObj.end()) throw pathException("No such key in JSON", identifier);
+            return ResultJSON::borrow(member->second);
         }
         case INT_LITERAL: {
-            return {INT, get<long long>(expression.value)};
+            return ResultJSON(ValueJSON(get<long long>(expression.value)));
         }
         case FLOAT_LITERAL: {
-            return {FLOAT, get<double>(expression.value)};
+            return ResultJSON(ValueJSON(get<double>(expression.value)));
         }
         case GET_MEMBER: {
             const auto& identifier = get<string>(expression.value);
-            if(!currentObj.contains(identifier)) throw pathException("No such key in JSON", identifier);
-            if(currentObj.at(identifier).type != OBJECT) throw pathException("This path should be an object", identifier);
-            const unordered_map<string, ValueJSON> obj = get<unordered_map<string, ValueJSON>>(currentObj.at(identifier).value);
+            const auto member = currentObj.find(identifier);
+            if(member == currentObj.end()) throw pathException("No such key in JSON", identifier);
+            if(member->second.type != OBJECT) throw pathException("This path should be an object", identifier);
             const auto& next = expression.children.at(0);
             try {
-                return executeExpression(JSON, next, obj);
+                return executeExpression(JSON, next, member->second.asObject());
             } catch (pathException& e) {
                 e.appendPathFront(identifier + '.');
                 throw;
@@ -247,9 +429,10 @@ ValueJSON executeExpression(const unordered_map<string, ValueJSON>& JSON, const
         }
         case GET_SUBSCRIPT: {
             const auto& identifier = get<string>(expression.value);
-            if(!currentObj.contains(identifier)) throw pathException("No such key in JSON", identifier);
-            if(currentObj.at(identifier).type != ARRAY) throw pathException("This path should be an array", identifier);
-            const vector<ValueJSON> array = get<vector<ValueJSON>>(currentObj.at(identifier).value);
+            const auto member = currentObj.find(identifier);
+            if(member == currentObj.end()) throw pathException("No such key in JSON", identifier);
+            if(member->second.type != ARRAY) throw pathException("This path should be an array", identifier);
+            const ArrayJSON& array = member->second.asArray();
             const Node& next = expression.children.at(0);
 
             try {
@@ -261,45 +444,206 @@ ValueJSON executeExpression(const unordered_map<string, ValueJSON>& JSON, const
         }
         case ONLY_SUBSCRIPT:
             throw executeException("Grave error, switch case ONLY_SUBSCRIPT should be impossible!");
-        case MAX: {
-            return getMax(JSON, expression);
-        }
-        case MIN: {
-            return getMin(JSON, expression);
+        case MAX:
+        case MIN:
+        case SIZE:
+        case SUM:
+        case AVG:
+        case COUNT:
+        case STDDEV:
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE:
+            return ResultJSON(applyAction(expression.action, executeArguments(JSON, expression)));
+    }
+    throw executeException("Grave error, switch case leaked!");
+}
+
+/**
+ *
+ * @param JSON entire JSON as a tape
+ * @param expression expression to execute
+ * @param currentObj current object function is in
+ * @return evaluated expression on currentObj
+ */
+ResultJSON executeExpression(const TapeJSON& JSON, const Node& expression, TapeRef currentObj);
+
+ResultJSON executeExpression(const TapeJSON& JSON, const Node& expression) { // NOLINT(*-no-recursion)
+    return executeExpression(JSON, expression, TapeRef::root(JSON));
+}
+
+/**
+ *
+ * @param JSON entire JSON as a tape
+ * @param expression intermediary array node
+ * @param array array on the tape to pick from
+ * @return evaluated subscript expression
+ */
+ResultJSON getItemFromArray(const TapeJSON& JSON, const Node& expression, // NOLINT(*-no-recursion)
+                            const TapeRef array) {
+
+    ResultJSON sub;
+    try {
+        sub = executeExpression(JSON, *expression.subscript);
+    } catch (pathException& e) {
+        e.appendPathFront("[");
+        e.appendPathBack("]");
+        throw;
+    }
+
+    if(sub->type != INT) throw pathException("Subscript should be an integer", "");
+    const long long index = sub->asInt();
+    const optional<TapeRef> arrayItem = index < 0 ? nullopt : array.item(index);
+    if(!arrayItem)
+        throw pathException("Index was out of bounds for array of size " + to_string(array.size()), '[' + to_string(index) + ']');
+    if(expression.action == ONLY_SUBSCRIPT) return ResultJSON(arrayItem->toValue());
+    const auto& next = expression.children.at(0);
+    if(expression.action == GET_MEMBER) {
+        if(arrayItem->type() != OBJECT) throw pathException("This path should be an object", '[' + to_string(index) + ']');
+        try {
+            return executeExpression(JSON, next, *arrayItem);
+        } catch (pathException& e) {
+            e.appendPathFront('[' + to_string(index) + ']');
+            throw;
         }
-        case SIZE: {
-            return getSize(JSON, expression);
+    }
+    if(expression.action == GET_SUBSCRIPT) {
+        if(arrayItem->type() != ARRAY) throw pathException("This path should be an array", '[' + to_string(index) + ']');
+        try {
+            return getItemFromArray(JSON, next, *arrayItem);
+        } catch (pathException& e) {
+            e.appendPathFront('[' + to_string(index) + ']');
+            throw;
         }
-        case ADD: {
-            const auto& [a, b] = getOperands(JSON, expression);
-            if(a.type == INT && b.type == INT)
-                return {INT, get<long long>(a.value) + get<long long>(b.value)};
-            return {FLOAT, extractDouble(a) + extractDouble(b)};
+    }
+    throw executeException("Unexpected action");
+}
+
+ResultJSON executeExpression(const TapeJSON& JSON, const Node& expression, // NOLINT(*-no-recursion)
+                             const TapeRef currentObj) {
+    switch (expression.action) {
+        case IDENTIFIER: {
+            const auto& identifier = get<string>(expression.value);
+            const auto member = currentObj.member(identifier);
+            if(!member) throw pathException("No such key in JSON", identifier);
+            return ResultJSON(member->toValue());
         }
-        case SUBTRACT: {
-            const auto& [a, b] = getOperands(JSON, expression);
-            if(a.type == INT && b.type == INT)
-                return {INT, get<long long>(a.value) - get<long long>(b.value)};
-            return {FLOAT, extractDouble(a) - extractDouble(b)};
+        case INT_LITERAL: {
+            return ResultJSON(ValueJSON(get<long long>(expression.value)));
         }
-        case MULTIPLY: {
-            const auto& [a, b] = getOperands(JSON, expression);
-            if(a.type == INT && b.type == INT)
-                return {INT, get<long long>(a.value) * get<long long>(b.value)};
-            return {FLOAT, extractDouble(a) * extractDouble(b)};
+        case FLOAT_LITERAL: {
+            return ResultJSON(ValueJSON(get<double>(expression.value)));
         }
-        case DIVIDE: {
-            const auto& [a, b] = getOperands(JSON, expression);
-            if(a.type == INT && b.type == INT)
-                return {INT, get<long long>(a.value) / get<long long>(b.value)};
-            return {FLOAT, extractDouble(a) / extractDouble(b)};
+        case GET_MEMBER: {
+            const auto& identifier = get<string>(expression.value);
+            const auto member = currentObj.member(identifier);
+            if(!member) throw pathException("No such key in JSON", identifier);
+            if(member->type() != OBJECT) throw pathException("This path should be an object", identifier);
+            try {
+                return executeExpression(JSON, expression.children.at(0), *member);
+            } catch (pathException& e) {
+                e.appendPathFront(identifier + '.');
+                throw;
+            }
         }
-        case RAISE: {
-            const auto& [a, b] = getOperands(JSON, expression);
-            if(a.type == INT && b.type == INT)
-                return {INT, llround(pow(get<long long>(a.value), get<long long>(b.value)))};
-            return {FLOAT, pow(extractDouble(a), extractDouble(b))};
+        case GET_SUBSCRIPT: {
+            const auto& identifier = get<string>(expression.value);
+            const auto member = currentObj.member(identifier);
+            if(!member) throw pathException("No such key in JSON", identifier);
+            if(member->type() != ARRAY) throw pathException("This path should be an array", identifier);
+            try {
+                return getItemFromArray(JSON, expression.children.at(0), *member);
+            } catch (pathException& e) {
+                e.appendPathFront(identifier);
+                throw;
+            }
         }
+        case ONLY_SUBSCRIPT:
+            throw executeException("Grave error, switch case ONLY_SUBSCRIPT should be impossible!");
+        case MAX:
+        case MIN:
+        case SIZE:
+        case SUM:
+        case AVG:
+        case COUNT:
+        case STDDEV:
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE:
+            return ResultJSON(applyAction(expression.action, executeArguments(JSON, expression)));
     }
     throw executeException("Grave error, switch case leaked!");
 }
+
+
+/**
+ *
+ * @param expression expression executed on the object or JSON the filter stands for
+ * @param current filter of the object the expression is executed on
+ * @param root filter of the entire JSON
+ */
+void collectPaths(const Node& expression, PathFilter& current, PathFilter& root);
+
+/**
+ *
+ * @param expression intermediary array node
+ * @param array filter of the array the item is picked from
+ * @param root filter of the entire JSON
+ */
+void collectSubscriptPaths(const Node& expression, PathFilter& array, PathFilter& root) { // NOLINT(*-no-recursion)
+    collectPaths(*expression.subscript, root, root);
+    if(array.items == nullptr) array.items = make_unique<PathFilter>();
+    PathFilter& items = *array.items;
+    switch(expression.action) {
+        case ONLY_SUBSCRIPT:
+            items.everything = true;
+            break;
+        case GET_MEMBER:
+            collectPaths(expression.children.at(0), items, root);
+            break;
+        case GET_SUBSCRIPT:
+            collectSubscriptPaths(expression.children.at(0), items, root);
+            break;
+        default: throw executeException("Unexpected action");
+    }
+}
+
+void collectPaths(const Node& expression, PathFilter& current, PathFilter& root) { // NOLINT(*-no-recursion)
+    switch(expression.action) {
+        case IDENTIFIER:
+            current.members[get<string>(expression.value)].everything = true;
+            break;
+        case INT_LITERAL:
+        case FLOAT_LITERAL:
+            break;
+        case GET_MEMBER:
+            collectPaths(expression.children.at(0), current.members[get<string>(expression.value)], root);
+            break;
+        case GET_SUBSCRIPT:
+            collectSubscriptPaths(expression.children.at(0), current.members[get<string>(expression.value)], root);
+            break;
+        case ONLY_SUBSCRIPT:
+            throw executeException("Grave error, switch case ONLY_SUBSCRIPT should be impossible!");
+        default:
+            // functions and operators execute their arguments on the entire JSON
+            for(const Node& child : expression.children) {
+                collectPaths(child, root, root);
+            }
+    }
+}
+
+PathFilter referencedPaths(const Node& expression) {
+    PathFilter root;
+    collectPaths(expression, root, root);
+    return root;
+}
+
+PathFilter referencedPaths(const span<const Node* const> expressions) {
+    PathFilter root;
+    for(const Node* expression : expressions) collectPaths(*expression, root, root);
+    return root;
+}
\ No newline at end of file
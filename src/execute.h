@@ -1,17 +1,125 @@
 #ifndef EXECUTE_H
 #define EXECUTE_H
+#include <span>
 #include <utility>
 
 #include "expression.h"
+#include "parseJSON.h"
 #include "value.h"
 
 /**
+ * Result of an evaluation, either a value of the evaluated JSON referred to where it is
+ * or a value computed by the expression that the result owns.
+ * A borrowed result is valid as long as the JSON it was evaluated on
+ */
+class ResultJSON {
+    ValueJSON owned;
+    const ValueJSON* borrowed = nullptr;
+
+public:
+    ResultJSON() = default;
+
+    /**
+     *
+     * @param value computed value, owned by the result
+     */
+    explicit ResultJSON(ValueJSON value)
+        : owned(std::move(value)) {}
+
+    /**
+     *
+     * @param value value of the JSON, not copied
+     * @return result referring to the value
+     */
+    static ResultJSON borrow(const ValueJSON& value) {
+        ResultJSON result;
+        result.borrowed = &value;
+        return result;
+    }
+
+    [[nodiscard]] bool isBorrowed() const {
+        return borrowed != nullptr;
+    }
+
+    [[nodiscard]] const ValueJSON& value() const {
+        return borrowed != nullptr ? *borrowed : owned;
+    }
+
+    // results are passed wherever a value is read, like toString or writeJSON
+    operator const ValueJSON&() const { // NOLINT(*-explicit-constructor)
+        return value();
+    }
+
+    const ValueJSON& operator*() const {
+        return value();
+    }
+
+    const ValueJSON* operator->() const {
+        return &value();
+    }
+
+    /**
+     *
+     * @return the value, copied out of the JSON if it is borrowed
+     */
+    [[nodiscard]] ValueJSON release() && {
+        if(borrowed != nullptr) return *borrowed;
+        return std::move(owned);
+    }
+};
+
+/**
+ * Paths resolve to references into the JSON, only computed values are made
  *
  * @param JSON entire JSON object
  * @param expression expression to execute
- * @return evaluated expression on JSON
+ * @return evaluated expression on JSON, borrowed from it if it is a value of the JSON
+ */
+ResultJSON executeExpression(const ObjectJSON& JSON, const Node& expression);
+
+/**
+ * Executes the expression directly on a tape, only the result is materialized
+ *
+ * @param JSON entire JSON as a tape
+ * @param expression expression to execute
+ * @return evaluated expression on JSON, always owned
+ */
+ResultJSON executeExpression(const TapeJSON& JSON, const Node& expression);
+
+/**
+ * Picks the item of the array and executes the rest of the path on it
+ *
+ * @param JSON entire JSON object the subscript is evaluated on
+ * @param expression intermediary array node
+ * @param array array to pick from
+ * @return evaluated subscript expression, borrowed from the JSON if it is a value of it
+ */
+ResultJSON getItemFromArray(const ObjectJSON& JSON, const Node& expression, const ArrayJSON& array);
+
+/**
+ * Applies a function or binary operator, shared by the tree and the tape backends and the bytecode
+ *
+ * @param action function or binary operator
+ * @param arguments evaluated arguments or operands
+ * @return result of the function or operator
+ */
+ValueJSON applyAction(NodeAction action, std::span<const ResultJSON> arguments);
+
+/**
+ * Collects every path of the JSON that executing the expression can visit
+ *
+ * @param expression expression to execute
+ * @return filter that parses only the visited paths
  */
-ValueJSON executeExpression(const std::unordered_map<std::string, ValueJSON>& JSON, const Node& expression);
+PathFilter referencedPaths(const Node& expression);
+
+/**
+ * Collects every path of the JSON that executing any of the expressions can visit
+ *
+ * @param expressions expressions to execute
+ * @return filter that parses only the paths visited by any of them
+ */
+PathFilter referencedPaths(std::span<const Node* const> expressions);
 
 class executeException : public std::exception {
     std::string message;
@@ -32,7 +140,9 @@ class pathException final : public executeException {
 
 public:
     explicit pathException(std::string msg, std::string path)
-        : executeException(move(msg)), path(move(path)) {}
+        : executeException(move(msg)), path(move(path)) {
+        full = std::string(executeException::what()) + "\nWrong path: " + this->path;
+    }
 
     [[nodiscard]] const char* what() const noexcept override
     {
@@ -1,4 +1,5 @@
 #include "expression.h"
+#include "number.h"
 
 #include <complex>
 #include <memory>
@@ -9,7 +10,8 @@
 using namespace std;
 
 const static unordered_map<string, NodeAction> funcMap =
-    {{"max", MAX}, {"min", MIN}, {"size", SIZE}};
+    {{"max", MAX}, {"min", MIN}, {"size", SIZE},
+     {"sum", SUM}, {"avg", AVG}, {"count", COUNT}, {"stddev", STDDEV}};
 
 const static unordered_map<char, NodeAction> operatorMap =
     {{'+', ADD}, {'-', SUBTRACT}, {'*', MULTIPLY}, {'/', DIVIDE}, {'^', RAISE}};
@@ -24,6 +26,16 @@ const static unordered_map<char, NodeAction> operatorMap =
  */
 unique_ptr<Node> parseExpression(const string& expression, string::size_type& pos);
 
+/**
+ * Moves pos past whitespace, allowed between the tokens of an expression
+ *
+ * @param expression complete string expression
+ * @param pos current position in expression
+ */
+inline void skipWhitespace(const string& expression, string::size_type& pos) {
+    while(pos < expression.size() && isspace(static_cast<unsigned char>(expression[pos]))) pos++;
+}
+
 /**
  *
  * @param c character to check
@@ -86,6 +98,7 @@ string parseIdentifier(const string& expression, string::size_type& pos) {
  * @return rest of the path as node
  */
 unique_ptr<Node> parseRestOfPath(const string& expression, string::size_type& pos) { // NOLINT(*-no-recursion)
+    skipWhitespace(expression, pos);
     if(pos == expression.size() || isArithmeticOperator(expression[pos])
         || expression[pos] == ']' || expression[pos] == ',' || expression[pos] == ')') {
         auto leaf = make_unique<Node>(IDENTIFIER);
@@ -93,7 +106,8 @@ unique_ptr<Node> parseRestOfPath(const string& expression, string::size_type& po
     }
     if(expression[pos] == '.') { // access member from this identifier
         auto parent = make_unique<Node>(GET_MEMBER);
-        const string identifier = parseIdentifier(expression, ++pos);
+        skipWhitespace(expression, ++pos);
+        const string identifier = parseIdentifier(expression, pos);
         const unique_ptr<Node> child = parseRestOfPath(expression, pos);
         child->value = identifier;
         parent->children.push_back(move(*child));
@@ -103,7 +117,9 @@ unique_ptr<Node> parseRestOfPath(const string& expression, string::size_type& po
         auto parent = make_unique<Node>(GET_SUBSCRIPT);
         auto middle = Node(ONLY_SUBSCRIPT);
         middle.subscript = parseExpression(expression, ++pos);
-        pos++;
+        if(pos == expression.size() || expression[pos] != ']')
+            throw ExpressionParseException("Missing closing bracket", expression.c_str(), pos);
+        skipWhitespace(expression, ++pos);
         if(expression[pos] == '.' || expression[pos] == '[') {
             const unique_ptr<Node> leaf = parseRestOfPath(expression, pos);
             middle.children = move(leaf->children);
@@ -129,7 +145,7 @@ vector<Node> parseFunction(const string& expression, string::size_type& pos) { /
             throw ExpressionParseException("Missing closing bracket",
                     expression.c_str(), pos);
         if(expression[pos] == ',') {
-            pos++;
+            skipWhitespace(expression, ++pos);
             if(pos == expression.size())
                 throw ExpressionParseException("Missing closing bracket",
                         expression.c_str(), pos);
@@ -161,8 +177,9 @@ unique_ptr<Node> parseOperand(const string& expression, string::size_type& pos)
         const char& c = expression[pos];
         if(isalpha(c) || c == '_' || c == '$') {
             // check if the identifier is actually a function
-            if(const string identifier = parseIdentifier(expression, pos);
-                funcMap.contains(identifier) && pos < expression.size() && expression[pos] == '(') {
+            const string identifier = parseIdentifier(expression, pos);
+            skipWhitespace(expression, pos);
+            if(funcMap.contains(identifier) && pos < expression.size() && expression[pos] == '(') {
                 auto func = make_unique<Node>(funcMap.at(identifier));
                 func->children = parseFunction(expression, ++pos);
                 return func;
@@ -173,20 +190,21 @@ unique_ptr<Node> parseOperand(const string& expression, string::size_type& pos)
             }
         }
         if(isdigit(c) || c == '-') {
-            size_t intPos;
-            size_t floatPos;
-            const string numberToParse = expression.substr(pos);
-            const long long intNumber = stoll(numberToParse, &intPos);
-            const double floatNumber = stod(numberToParse, &floatPos);
-            pos += floatPos; // number as float cannot be smaller than same number as integer
-            if(intPos == floatPos) {
-                auto number = make_unique<Node>(INT_LITERAL);
-                number->value = intNumber;
-                return number;
-            } else {
-                auto number = make_unique<Node>(FLOAT_LITERAL);
-                number->value = floatNumber;
-                return number;
+            long long integer;
+            double floating;
+            switch(parseNumber(expression, pos, integer, floating)) {
+                case INTEGER_NUMBER: {
+                    auto number = make_unique<Node>(INT_LITERAL);
+                    number->value = integer;
+                    return number;
+                }
+                case FLOAT_NUMBER: {
+                    auto number = make_unique<Node>(FLOAT_LITERAL);
+                    number->value = floating;
+                    return number;
+                }
+                case NOT_A_NUMBER:
+                    throw ExpressionParseException("Invalid number literal", expression.c_str(), pos);
             }
         }
         throw ExpressionParseException("Unexpected character", expression.c_str(), pos);
@@ -194,6 +212,26 @@ unique_ptr<Node> parseOperand(const string& expression, string::size_type& pos)
     throw ExpressionParseException("Unexpected stuff", expression.c_str(), pos);
 }
 
+/**
+ * Parses the number literal after a unary minus, whitespace may separate the sign from the number
+ *
+ * @param expression complete string expression
+ * @param pos position of the minus. Moves the pos
+ * @return root node of the negative number literal
+ */
+unique_ptr<Node> parseNegated(const string& expression, string::size_type& pos) {
+    string::size_type digits = pos + 1;
+    skipWhitespace(expression, digits);
+    // the sign stays part of the literal, anything but a number after it fails as an invalid number literal
+    if(digits == pos + 1 || digits == expression.size() || !isdigit(expression[digits]))
+        return parseOperand(expression, pos);
+    pos = digits;
+    unique_ptr<Node> number = parseOperand(expression, pos);
+    if(number->action == INT_LITERAL) number->value = -get<long long>(number->value);
+    else number->value = -get<double>(number->value);
+    return number;
+}
+
 /**
  * Parses the whole expression into a linked list
  * that can be more easily executed
@@ -207,6 +245,7 @@ unique_ptr<Node> parseExpression(const string& expression, string::size_type& po
     vector<unique_ptr<Node>> parsedExpression;
 
     int depth = 0;
+    skipWhitespace(expression, pos);
     while(pos < expression.size() && expression[pos] != ']' && expression[pos] != ','
         && (expression[pos] != ')' || depth > 0)) {
         const char& c = expression[pos];
@@ -220,7 +259,7 @@ unique_ptr<Node> parseExpression(const string& expression, string::size_type& po
         } else if(isArithmeticOperator(c)) {
             if(c == '-' && (parsedExpression.empty() || isArithmeticOperator(parsedExpression.back()->action)
                 && parsedExpression.back()->children.empty())) {
-                parsedExpression.push_back(parseOperand(expression, pos));
+                parsedExpression.push_back(parseNegated(expression, pos));
             } else {
                 parsedExpression.emplace_back(make_unique<Node>(operatorMap.at(c)));
                 pos++;
@@ -228,6 +267,7 @@ unique_ptr<Node> parseExpression(const string& expression, string::size_type& po
         } else {
             parsedExpression.push_back(parseOperand(expression, pos));
         }
+        skipWhitespace(expression, pos);
     }
     if(depth != 0) throw ExpressionParseException("Missing closing brackets", expression.c_str(), pos);
     if(parsedExpression.size() == 1 && !isArithmeticOperator(parsedExpression.front()->action))
@@ -280,9 +320,8 @@ unique_ptr<Node> parseExpression(const string& expression, string::size_type& po
  * @param expression complete string expression
  * @return root node of the expression tree/linked list
  */
-Node parseExpression(string expression) {
+Node parseExpression(const string& expression) {
     string::size_type pos = 0;
-    erase_if(expression, [](const unsigned char c){return iswspace(c);});
     Node result = std::move(*parseExpression(expression, pos));
     if(pos < expression.size()) throw ExpressionParseException("Unexpected character", expression.c_str(), pos);
     return result;
@@ -15,6 +15,10 @@ enum NodeAction {
     MAX,
     MIN,
     SIZE,
+    SUM,
+    AVG,
+    COUNT,
+    STDDEV,
     ADD,
     SUBTRACT,
     MULTIPLY,
@@ -38,7 +42,7 @@ struct Node {
  * @param expression complete string expression
  * @return root node of the expression tree/linked list
  */
-Node parseExpression(std::string expression);
+Node parseExpression(const std::string& expression);
 
 /**
  *
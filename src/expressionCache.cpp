@@ -0,0 +1,52 @@
+#include "expressionCache.h"
+
+#include <cctype>
+
+using namespace std;
+
+string normalizeExpression(const string_view expression) {
+    string normalized;
+    normalized.reserve(expression.size());
+    bool space = false;
+    for(const char c : expression) {
+        if(isspace(static_cast<unsigned char>(c))) {
+            space = true;
+            continue;
+        }
+        if(space && !normalized.empty()) normalized += ' ';
+        space = false;
+        normalized += c;
+    }
+    return normalized;
+}
+
+shared_ptr<const Bytecode> ExpressionCache::compile(const string& expression) {
+    string normalized = normalizeExpression(expression);
+    {
+        lock_guard lock(mutex);
+        if(const auto found = index.find(normalized); found != index.end()) {
+            hitCount++;
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->second;
+        }
+        missCount++;
+    }
+    // parsed without holding the lock, other expressions are looked up meanwhile
+    auto program = make_shared<const Bytecode>(compileExpression(parseExpression(expression)));
+    if(capacity == 0) return program;
+
+    lock_guard lock(mutex);
+    if(const auto found = index.find(normalized); found != index.end()) return found->second->second;
+    if(entries.size() == capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(std::move(normalized), program);
+    index.emplace(entries.front().first, entries.begin());
+    return program;
+}
+
+ExpressionCache::Stats ExpressionCache::stats() const {
+    lock_guard lock(mutex);
+    return {hitCount, missCount, entries.size()};
+}
@@ -0,0 +1,69 @@
+#ifndef EXPRESSIONCACHE_H
+#define EXPRESSIONCACHE_H
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "bytecode.h"
+
+// default number of compiled expressions a JSON object keeps
+constexpr std::size_t EXPRESSION_CACHE_SIZE = 1024;
+
+/**
+ * Bounded cache of compiled expressions, the least recently used one is dropped when it is full.
+ * Expressions are looked up by their normalized text, expressions that fail to parse are not kept.
+ * Safe to use from several threads, an expression missing in two threads at once may be compiled twice
+ */
+class ExpressionCache {
+    using Entry = std::pair<std::string, std::shared_ptr<const Bytecode>>;
+
+    std::size_t capacity;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // views the text of the entries
+    mutable std::mutex mutex;
+    std::size_t hitCount = 0;
+    std::size_t missCount = 0;
+
+public:
+    struct Stats {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t size; // expressions in the cache
+    };
+
+    /**
+     *
+     * @param capacity most expressions kept, 0 keeps none
+     */
+    explicit ExpressionCache(std::size_t capacity = EXPRESSION_CACHE_SIZE)
+        : capacity(capacity) {}
+
+    ExpressionCache(const ExpressionCache&) = delete;
+    ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+    /**
+     * Compiles the expression only the first time its normalized text is seen
+     *
+     * @param expression expression as the user wrote it, parse errors point into it
+     * @return compiled expression, valid even after it is dropped from the cache
+     */
+    std::shared_ptr<const Bytecode> compile(const std::string& expression);
+
+    [[nodiscard]] Stats stats() const;
+};
+
+/**
+ * Trims the whitespace around the expression and collapses every run of whitespace inside it into one space.
+ * The parser either skips a whole run or stops at its first character, so both texts parse the same
+ *
+ * @param expression expression text
+ * @return text the expression is cached by
+ */
+std::string normalizeExpression(std::string_view expression);
+
+#endif //EXPRESSIONCACHE_H
@@ -0,0 +1,121 @@
+#include "input.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <iostream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+// no mmap, everything goes through the buffered fallback
+InputJSON::InputJSON(const string& filePath) {
+    if(filePath == "-") {
+        stringstream ss;
+        ss << cin.rdbuf();
+        buffer = ss.str();
+    } else {
+        ifstream in(filePath, ios::binary);
+        if(!in.good()) {
+            throw runtime_error{"Could not open " + filePath};
+        }
+        stringstream ss;
+        ss << in.rdbuf();
+        buffer = ss.str();
+    }
+    data = buffer.data();
+    length = buffer.size();
+}
+
+void InputJSON::readStream(int) {}
+
+void InputJSON::unmap() noexcept {}
+
+#else
+
+InputJSON::InputJSON(const string& filePath) {
+    if(filePath == "-") {
+        readStream(STDIN_FILENO);
+        return;
+    }
+    const int fd = open(filePath.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw runtime_error{"Could not open " + filePath};
+    }
+    struct stat info{};
+    if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map != MAP_FAILED) {
+            madvise(map, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(map);
+            length = info.st_size;
+            mapped = true;
+            close(fd);
+            return;
+        }
+    }
+    // pipes, devices and files that could not be mapped
+    try {
+        readStream(fd);
+    } catch(...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+}
+
+/**
+ * Reads the stream until EOF into the buffer
+ *
+ * @param fd file descriptor to read
+ */
+void InputJSON::readStream(const int fd) {
+    constexpr string::size_type chunk = 1 << 16;
+    string::size_type size = 0;
+    while(true) {
+        buffer.resize(size + chunk);
+        const ssize_t count = read(fd, &buffer[size], chunk);
+        if(count < 0) throw runtime_error{"Could not read input"};
+        if(count == 0) break;
+        size += count;
+    }
+    buffer.resize(size);
+    data = buffer.data();
+    length = buffer.size();
+}
+
+void InputJSON::unmap() noexcept {
+    if(mapped) munmap(const_cast<char*>(data), length);
+}
+
+#endif
+
+InputJSON::~InputJSON() {
+    unmap();
+}
+
+InputJSON::InputJSON(InputJSON&& other) noexcept {
+    *this = std::move(other);
+}
+
+InputJSON& InputJSON::operator=(InputJSON&& other) noexcept {
+    if(this == &other) return *this;
+    unmap();
+    mapped = other.mapped;
+    length = other.length;
+    buffer = std::move(other.buffer);
+    data = mapped ? other.data : buffer.data();
+    other.data = nullptr;
+    other.length = 0;
+    other.mapped = false;
+    return *this;
+}
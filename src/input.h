@@ -0,0 +1,53 @@
+#ifndef INPUT_H
+#define INPUT_H
+#include <string>
+#include <string_view>
+
+/**
+ * Owner of the raw bytes of a JSON input.
+ * Regular files are memory mapped so the parser reads straight from the page cache,
+ * pipes, character devices and stdin ("-") are read into a buffer instead.
+ * The view returned by view() is valid as long as this object is alive
+ */
+class InputJSON {
+    const char* data = nullptr;
+    std::string::size_type length = 0;
+    bool mapped = false;
+    std::string buffer; // storage when the input could not be mapped
+
+    void readStream(int fd);
+    void unmap() noexcept;
+
+public:
+    /**
+     *
+     * @param filePath file path of the JSON, "-" reads stdin
+     */
+    explicit InputJSON(const std::string& filePath);
+
+    ~InputJSON();
+
+    InputJSON(const InputJSON&) = delete;
+    InputJSON& operator=(const InputJSON&) = delete;
+
+    InputJSON(InputJSON&& other) noexcept;
+    InputJSON& operator=(InputJSON&& other) noexcept;
+
+    /**
+     *
+     * @return contents of the input
+     */
+    [[nodiscard]] std::string_view view() const {
+        return {data, length};
+    }
+
+    /**
+     *
+     * @return true if the contents are memory mapped, false if they were read into a buffer
+     */
+    [[nodiscard]] bool isMapped() const {
+        return mapped;
+    }
+};
+
+#endif //INPUT_H
@@ -0,0 +1,103 @@
+#include "lines.h"
+
+#include <deque>
+#include <future>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+
+#include "execute.h"
+#include "expression.h"
+#include "parseJSON.h"
+#include "simplify.h"
+#include "threadPool.h"
+
+using namespace std;
+
+/**
+ * Evaluates the expression on every line of the chunk
+ *
+ * @param chunk whole lines of JSON Lines input
+ * @param expression parsed expression
+ * @param filter paths of the records the expression visits
+ * @return one result per non-empty line, each ending with a newline
+ */
+string evaluateChunk(const string& chunk, const Node& expression, const PathFilter& filter) {
+    string results;
+    // the records of a chunk share one arena, freed at once when the chunk is done,
+    // and one dictionary so records of the same shape share their keys
+    pmr::monotonic_buffer_resource arena(chunk.size());
+    KeysJSON keys(&arena);
+    string_view rest = chunk;
+    while(!rest.empty()) {
+        const string_view::size_type newline = rest.find('\n');
+        const string_view line = rest.substr(0, newline);
+        rest = newline == string_view::npos ? string_view() : rest.substr(newline + 1);
+        if(line.find_first_not_of(" \t\r") == string_view::npos) continue;
+        try {
+            // the record is printed before the chunk is gone, its strings can point into the chunk
+            appendJSON(results, executeExpression(parseJSON(line, filter, keys, true), expression));
+        } catch(const exception& e) {
+            results += "error: ";
+            results += e.what();
+        }
+        results += '\n';
+    }
+    return results;
+}
+
+/**
+ * Reads the next chunk of whole lines, the partial line at its end is kept in carry for the next chunk
+ *
+ * @param in JSON Lines input
+ * @param carry start of a line left over from the previous chunk
+ * @param chunkSize minimum size of the chunk
+ * @return the chunk, empty at the end of the input
+ */
+string readChunk(istream& in, string& carry, const string::size_type chunkSize) {
+    string chunk = std::move(carry);
+    carry.clear();
+    while(in) {
+        const string::size_type size = chunk.size();
+        chunk.resize(size + chunkSize);
+        in.read(&chunk[size], static_cast<streamsize>(chunkSize));
+        chunk.resize(size + in.gcount());
+        // a chunk ends at a newline, lines longer than the chunk size make the chunk grow
+        if(const string::size_type newline = chunk.rfind('\n'); newline != string::npos) {
+            carry = chunk.substr(newline + 1);
+            chunk.resize(newline + 1);
+            return chunk;
+        }
+    }
+    return chunk;
+}
+
+void evaluateLines(istream& in, ostream& out, const string& expression, const unsigned threads,
+                   const string::size_type chunkSize) {
+    const Node root = simplifyExpression(parseExpression(expression));
+    const PathFilter filter = referencedPaths(root);
+    string carry;
+
+    if(threads <= 1) {
+        for(string chunk = readChunk(in, carry, chunkSize); !chunk.empty(); chunk = readChunk(in, carry, chunkSize)) {
+            out << evaluateChunk(chunk, root, filter);
+        }
+        return;
+    }
+
+    ThreadPool pool(threads);
+    deque<future<string>> inFlight;
+    for(string chunk = readChunk(in, carry, chunkSize); !chunk.empty(); chunk = readChunk(in, carry, chunkSize)) {
+        if(inFlight.size() >= 2 * threads) {
+            out << pool.wait(inFlight.front());
+            inFlight.pop_front();
+        }
+        inFlight.push_back(pool.submit([chunk = std::move(chunk), &root, &filter] {
+            return evaluateChunk(chunk, root, filter);
+        }));
+    }
+    while(!inFlight.empty()) {
+        out << pool.wait(inFlight.front());
+        inFlight.pop_front();
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef LINES_H
+#define LINES_H
+#include <istream>
+#include <ostream>
+#include <string>
+
+// default size in bytes of the newline aligned chunks a JSON Lines input is read in
+constexpr std::string::size_type LINES_CHUNK_SIZE = 1 << 20;
+
+/**
+ * Evaluates the expression on every record of a JSON Lines input (one JSON object per line)
+ * and writes one result per line in input order. Empty lines are skipped, a record that fails
+ * to parse or evaluate writes "error: " and the message instead.
+ * The input is read in chunks of whole lines, at most two chunks per thread are in memory at once
+ *
+ * @param in JSON Lines input
+ * @param out output of the results
+ * @param expression expression to evaluate on every record
+ * @param threads number of threads evaluating chunks
+ * @param chunkSize minimum size of a chunk in bytes, chunks end at a newline
+ */
+void evaluateLines(std::istream& in, std::ostream& out, const std::string& expression, unsigned threads,
+                   std::string::size_type chunkSize = LINES_CHUNK_SIZE);
+
+#endif //LINES_H
@@ -1,30 +1,103 @@
+#include <charconv>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include "JSON.h"
+#include "lines.h"
 
 using namespace std; // only std allowed anyway
 
+/**
+ * Prints how to run the application
+ */
+void printUsage() {
+    cout << "Usage: ./json_eval [--snapshot] <json_file> <expression>\n"
+            "Or: ./json_eval [--threads N | --tape | --snapshot] -k <json_file>\n"
+            "Or: ./json_eval [--threads N] --lines <json_lines_file> <expression>\n"
+            "N is between 1 and 4 times the number of hardware threads\n"
+            "Example: ./json_eval test.json \"a.b[1]\"" << endl;
+}
+
+/**
+ *
+ * @param argument value of the --threads option
+ * @return number of threads, nothing if it isn't a number between 1 and 4 times the number of hardware threads
+ */
+optional<unsigned> parseThreads(const string& argument) {
+    long long threads = 0;
+    const char* end = argument.data() + argument.size();
+    if(const auto [ptr, ec] = from_chars(argument.data(), end, threads); ec != errc() || ptr != end) return nullopt;
+    const long long limit = 4 * static_cast<long long>(max(thread::hardware_concurrency(), 1u));
+    if(threads <= 0 || threads > limit) return nullopt;
+    return static_cast<unsigned>(threads);
+}
+
 int main(const int argc, char* argv[]) {
-    if (argc != 3) {
-        cout << "Usage: ./json_eval <json_file> <expression>\n"
-                "Or: ./json_eval -k <json_file>\n"
-                "Example: ./json_eval test.json \"a.b[1]\"" << endl;
+    vector<string> arguments(argv + 1, argv + argc);
+    unsigned threads = 1;
+    bool threadsGiven = false;
+    bool lines = false;
+    bool tape = false;
+    bool snapshot = false;
+    while(!arguments.empty()) {
+        if(arguments[0] == "--threads" && arguments.size() >= 2) {
+            const optional<unsigned> parsed = parseThreads(arguments[1]);
+            if(!parsed) {
+                printUsage();
+                return -1;
+            }
+            threads = *parsed;
+            threadsGiven = true;
+            arguments.erase(arguments.begin(), arguments.begin() + 2);
+        } else if(arguments[0] == "--tape") {
+            tape = true;
+            arguments.erase(arguments.begin());
+        } else if(arguments[0] == "--snapshot") {
+            snapshot = true;
+            arguments.erase(arguments.begin());
+        } else if(arguments[0] == "--lines") {
+            lines = true;
+            arguments.erase(arguments.begin());
+        } else break;
+    }
+
+    // every option only applies to some modes, the others reject it instead of ignoring it
+    const bool keep = !arguments.empty() && arguments[0] == "-k";
+    const bool unused = lines ? tape || snapshot : !keep && (threadsGiven || tape);
+    if (arguments.size() != 2 || unused) {
+        printUsage();
         return -1;
     }
 
-    if (string(argv[1]) == "-k") {
-        const auto json = JSON(argv[2]);
+    if (lines) {
+        if (arguments[0] == "-") {
+            evaluateLines(cin, cout, arguments[1], threads);
+        } else {
+            ifstream in(arguments[0], ios::binary);
+            if (!in.good()) {
+                cout << "Could not open " << arguments[0] << endl;
+                return -1;
+            }
+            evaluateLines(in, cout, arguments[1], threads);
+        }
+    } else if (arguments[0] == "-k") {
+        const auto json = JSON(arguments[1], snapshot ? SNAPSHOT : tape ? TAPE : EAGER, threads);
         do {
             string input;
             cin >> input;
             if (input == "-x") break;
-            cout << toString(json.evaluate(input)) << endl;
+            writeJSON(cout, json.evaluate(input));
+            cout << endl;
         } while (true);
     } else {
-        const auto json = JSON(argv[1]);
-        const string input = argv[2];
+        // one expression, parse only what it needs unless a snapshot saves parsing altogether
+        const auto json = JSON(arguments[0], snapshot ? SNAPSHOT : LAZY);
+        const string input = arguments[1];
 
-        cout << toString(json.evaluate(input));
+        writeJSON(cout, json.evaluate(input));
     }
 
     return 0;
@@ -0,0 +1,53 @@
+#include "number.h"
+
+#include <charconv>
+
+using namespace std;
+
+inline bool isDigitAt(const string_view text, const string_view::size_type pos) {
+    return pos < text.size() && text[pos] >= '0' && text[pos] <= '9';
+}
+
+inline void skipDigits(const string_view text, string_view::size_type& pos) {
+    while(isDigitAt(text, pos)) pos++;
+}
+
+NumberType scanNumber(const string_view text, string_view::size_type& pos) {
+    NumberType type = INTEGER_NUMBER;
+    if(pos < text.size() && text[pos] == '-') pos++;
+    if(!isDigitAt(text, pos)) return NOT_A_NUMBER;
+    if(text[pos] == '0') pos++; // no leading zeroes
+    else skipDigits(text, pos);
+    if(pos < text.size() && text[pos] == '.') {
+        pos++;
+        if(!isDigitAt(text, pos)) return NOT_A_NUMBER;
+        skipDigits(text, pos);
+        type = FLOAT_NUMBER;
+    }
+    if(pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        pos++;
+        if(pos < text.size() && (text[pos] == '-' || text[pos] == '+')) pos++;
+        if(!isDigitAt(text, pos)) return NOT_A_NUMBER;
+        skipDigits(text, pos);
+        type = FLOAT_NUMBER;
+    }
+    return type;
+}
+
+NumberType parseNumber(const string_view text, string_view::size_type& pos, long long& integer, double& floating) {
+    string_view::size_type end = pos;
+    const NumberType type = scanNumber(text, end);
+    if(type == NOT_A_NUMBER) return NOT_A_NUMBER;
+    const char* first = text.data() + pos;
+    const char* last = text.data() + end;
+    if(type == INTEGER_NUMBER) {
+        if(const auto [ptr, error] = from_chars(first, last, integer); error == errc()) {
+            pos = end;
+            return INTEGER_NUMBER;
+        }
+        // too big for a long long, fall through to floating point
+    }
+    if(const auto [ptr, error] = from_chars(first, last, floating); error != errc()) return NOT_A_NUMBER;
+    pos = end;
+    return FLOAT_NUMBER;
+}
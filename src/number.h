@@ -0,0 +1,33 @@
+#ifndef NUMBER_H
+#define NUMBER_H
+#include <string_view>
+
+enum NumberType {
+    NOT_A_NUMBER,
+    INTEGER_NUMBER,
+    FLOAT_NUMBER
+};
+
+/**
+ * Moves past a number literal of the JSON grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ *
+ * @param text text with the number
+ * @param pos start of the number, moved past it. Unspecified if the number is malformed
+ * @return INTEGER_NUMBER if it has no fraction or exponent, FLOAT_NUMBER if it does,
+ * NOT_A_NUMBER if malformed
+ */
+NumberType scanNumber(std::string_view text, std::string_view::size_type& pos);
+
+/**
+ * Scans a number literal once and decodes it with from_chars, without temporary strings or exceptions.
+ * Integers that do not fit a long long are decoded as floating point
+ *
+ * @param text text with the number
+ * @param pos start of the number, moved past it if valid
+ * @param integer set for INTEGER_NUMBER
+ * @param floating set for FLOAT_NUMBER
+ * @return type of the number, NOT_A_NUMBER if malformed or out of range
+ */
+NumberType parseNumber(std::string_view text, std::string_view::size_type& pos, long long& integer, double& floating);
+
+#endif //NUMBER_H
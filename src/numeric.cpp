@@ -0,0 +1,142 @@
+#include "numeric.h"
+
+#include <algorithm>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NUMERIC_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+using IntegerKernel = long long (*)(span<const long long> numbers, bool largest);
+using FloatKernel = double (*)(span<const double> numbers, bool largest);
+
+long long findExtremeScalar(const span<const long long> numbers, const bool largest) {
+    return largest ? ranges::max(numbers) : ranges::min(numbers);
+}
+
+double findExtremeScalar(const span<const double> numbers, const bool largest) {
+    return largest ? ranges::max(numbers) : ranges::min(numbers);
+}
+
+#ifdef NUMERIC_X86
+
+// Four independent accumulators of 4 numbers each hide the latency of the compare so the loop is bound by
+// memory bandwidth. AVX2 has no 64-bit integer min or max, a compare and a blend take its place
+
+/**
+ *
+ * @param a integers
+ * @param b integers
+ * @param largest true for the largest, false for the smallest
+ * @return larger or smaller integer of each lane
+ */
+__attribute__((target("avx2")))
+inline __m256i extremeEpi64(const __m256i a, const __m256i b, const bool largest) {
+    const __m256i greater = _mm256_cmpgt_epi64(a, b);
+    return largest ? _mm256_blendv_epi8(b, a, greater) : _mm256_blendv_epi8(a, b, greater);
+}
+
+__attribute__((target("avx2")))
+long long findExtremeAVX2(const span<const long long> numbers, const bool largest) {
+    constexpr size_t STEP = 16;
+    if(numbers.size() < STEP) return findExtremeScalar(numbers, largest);
+    const long long* data = numbers.data();
+    __m256i accumulators[4];
+    for(int j = 0; j < 4; j++) accumulators[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 4 * j));
+    size_t i = STEP;
+    for(; i + STEP <= numbers.size(); i += STEP) {
+        for(int j = 0; j < 4; j++) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 4 * j));
+            accumulators[j] = extremeEpi64(accumulators[j], chunk, largest);
+        }
+    }
+    const __m256i merged = extremeEpi64(extremeEpi64(accumulators[0], accumulators[1], largest),
+                                        extremeEpi64(accumulators[2], accumulators[3], largest), largest);
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), merged);
+    long long result = findExtremeScalar(lanes, largest);
+    if(i < numbers.size()) {
+        const long long tail = findExtremeScalar(numbers.subspan(i), largest);
+        result = largest ? max(result, tail) : min(result, tail);
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+double findExtremeAVX2(const span<const double> numbers, const bool largest) {
+    constexpr size_t STEP = 16;
+    if(numbers.size() < STEP) return findExtremeScalar(numbers, largest);
+    const double* data = numbers.data();
+    __m256d accumulators[4];
+    for(int j = 0; j < 4; j++) accumulators[j] = _mm256_loadu_pd(data + 4 * j);
+    size_t i = STEP;
+    // the branch is outside the loop, min and max are separate instructions for floating point numbers
+    if(largest) {
+        for(; i + STEP <= numbers.size(); i += STEP) {
+            for(int j = 0; j < 4; j++) accumulators[j] = _mm256_max_pd(accumulators[j], _mm256_loadu_pd(data + i + 4 * j));
+        }
+        accumulators[0] = _mm256_max_pd(_mm256_max_pd(accumulators[0], accumulators[1]),
+                                        _mm256_max_pd(accumulators[2], accumulators[3]));
+    } else {
+        for(; i + STEP <= numbers.size(); i += STEP) {
+            for(int j = 0; j < 4; j++) accumulators[j] = _mm256_min_pd(accumulators[j], _mm256_loadu_pd(data + i + 4 * j));
+        }
+        accumulators[0] = _mm256_min_pd(_mm256_min_pd(accumulators[0], accumulators[1]),
+                                        _mm256_min_pd(accumulators[2], accumulators[3]));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, accumulators[0]);
+    double result = findExtremeScalar(lanes, largest);
+    if(i < numbers.size()) {
+        const double tail = findExtremeScalar(numbers.subspan(i), largest);
+        result = largest ? max(result, tail) : min(result, tail);
+    }
+    // min and max pick either of 0.0 and -0.0 as they compare equal, the scalar loop keeps the first one.
+    // Other numbers that compare equal are the same bits
+    if(result == 0) return *ranges::find(numbers, 0.0);
+    return result;
+}
+
+#endif
+
+/**
+ * Numeric kernels for the instruction sets this CPU supports
+ */
+struct NumericKernels {
+    IntegerKernel integers;
+    FloatKernel floats;
+    const char* name;
+};
+
+/**
+ * Picks the kernels for the instruction sets this CPU supports
+ *
+ * @return kernels and their name
+ */
+NumericKernels selectKernels() {
+#ifdef NUMERIC_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return {findExtremeAVX2, findExtremeAVX2, "avx2"};
+#endif
+    return {findExtremeScalar, findExtremeScalar, "scalar"};
+}
+
+inline const NumericKernels& activeKernels() {
+    static const NumericKernels kernels = selectKernels();
+    return kernels;
+}
+
+long long findExtreme(const span<const long long> numbers, const bool largest) {
+    return activeKernels().integers(numbers, largest);
+}
+
+double findExtreme(const span<const double> numbers, const bool largest) {
+    return activeKernels().floats(numbers, largest);
+}
+
+const char* numericInstructionSet() {
+    return activeKernels().name;
+}
@@ -0,0 +1,76 @@
+#ifndef NUMERIC_H
+#define NUMERIC_H
+#include <cmath>
+#include <span>
+
+/**
+ * Smallest or largest of the integers with the fastest instruction set of this CPU (AVX2 or scalar)
+ *
+ * @param numbers integers, not empty
+ * @param largest true for the largest, false for the smallest
+ * @return smallest or largest integer
+ */
+long long findExtreme(std::span<const long long> numbers, bool largest);
+
+/**
+ * Smallest or largest of the floating point numbers with the fastest instruction set of this CPU (AVX2 or scalar)
+ *
+ * @param numbers floating point numbers without NaN, not empty
+ * @param largest true for the largest, false for the smallest
+ * @return smallest or largest floating point number
+ */
+double findExtreme(std::span<const double> numbers, bool largest);
+
+/**
+ * Portable reference implementation of findExtreme
+ *
+ * @param numbers integers, not empty
+ * @param largest true for the largest, false for the smallest
+ * @return smallest or largest integer
+ */
+long long findExtremeScalar(std::span<const long long> numbers, bool largest);
+
+/**
+ * Portable reference implementation of findExtreme
+ *
+ * @param numbers floating point numbers without NaN, not empty
+ * @param largest true for the largest, false for the smallest
+ * @return smallest or largest floating point number
+ */
+double findExtremeScalar(std::span<const double> numbers, bool largest);
+
+/**
+ *
+ * @return name of the instruction set findExtreme dispatches to
+ */
+const char* numericInstructionSet();
+
+/**
+ * Running total of floating point numbers with Neumaier's compensation, the low-order bits
+ * every addition rounds off are gathered apart and added back at the end
+ */
+struct CompensatedSum {
+    double sum = 0;
+    double compensation = 0;
+
+    /**
+     *
+     * @param number number to add
+     */
+    void add(const double number) {
+        const double total = sum + number;
+        if(std::abs(sum) >= std::abs(number)) compensation += (sum - total) + number;
+        else compensation += (number - total) + sum;
+        sum = total;
+    }
+
+    /**
+     *
+     * @return compensated total
+     */
+    [[nodiscard]] double value() const {
+        return sum + compensation;
+    }
+};
+
+#endif //NUMERIC_H
@@ -1,295 +1,362 @@
 #include "parseJSON.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
 #include <iostream>
-#include <fstream>
 #include <memory>
-#include <sstream>
+#include <utility>
 
+#include "input.h"
+#include "number.h"
+#include "structural.h"
+#include "tape.h"
+#include "threadPool.h"
 #include "value.h"
 
 using namespace std;
 
 /**
- *TODO The reason that parsing and skipping is decoupled is that
- * I wanted to experiment with multi-threading the JSON parsing
- * by delegating parsing of larger nested objects or arrays to another thread
- * while still being able to continue parsing the rest
+ * Parsing and skipping are decoupled so that big objects and arrays can be parsed in parallel:
+ * the skip pass cuts them into batches of members which are parsed on other threads
+ * and stitched back together in order, see splitContainer
  */
 
 
-unordered_map<string, ValueJSON> parseObject(string json);
-ValueJSON parseValue(const string& json);
+ObjectJSON parseObject(string_view json, string_view::size_type& pos, const PathFilter* filter,
+                       pmr::memory_resource* resource, KeysJSON* keys, bool borrow);
+ValueJSON parseValue(string_view json, string_view::size_type& pos, const PathFilter* filter,
+                     pmr::memory_resource* resource, KeysJSON* keys, bool borrow);
+
+// filter of values whose content is not needed, objects are parsed empty and arrays keep only the type of items
+const static PathFilter typeOnly{};
 
 /**
  *
- * @param filePath file path of JSON
- * @return contents of the JSON file in string
+ * @param json JSON string
+ * @param pos position in json
+ * @return character at pos or '\0' if pos is past the end
  */
-string openFile(const string& filePath) {
-    ifstream in(filePath);
-    if(!in.good()) {
-        throw runtime_error{"Could not open " + filePath};
-    }
-    in.seekg(0, ios::end);
-    const long long size = in.tellg();
-    string buffer(size, ' ');
-    in.seekg(0);
-    in.read(&buffer[0], size);
-    return buffer;
+inline char peek(const string_view json, const string_view::size_type pos) {
+    return pos < json.size() ? json[pos] : '\0';
 }
 
 /**
  *
- * @param str string
- * @param amount characters to skip
- * @return str with the amount of characters skipped
+ * @param c character to check
+ * @return true iff c is JSON whitespace (space, tab, line feed, carriage return)
  */
-inline string skip(const string& str, const string::size_type amount) {
-    return &str[amount];
+inline bool isWhitespace(const char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
 }
 
 /**
+ * Moves pos past JSON whitespace. Most runs between tokens are a few characters long,
+ * longer ones like the indentation of pretty-printed files are skipped with the structural classifier
  *
- * @param str JSON string starting with number value
- * @return JSON string with the number value skipped
+ * @param json JSON string
+ * @param pos position in json
  */
-string skipNumber(const string& str) {
-    bool dot = false;
-    for(int i = 0; i < str.size(); i++) {
-        if(i == 0 && str[i] == '-') continue;
-        if(isdigit(str[i])) continue;
-        if(str[i] == '.') {
-            if(dot) throw JSONParseException("Multiple dots in a number");
-            dot = true;
-            continue;
-        }
-        if(str[i] == 'e' || str[i] == 'E') {
-            i++;
-            if(str[i] == '-' || str[i] == '+') i++;
-            if(isdigit(str[i])) {
-                continue;
-            }
-            throw JSONParseException("Unexpected character after exponent");
-        }
-        return &str[i];
+inline void skipWhitespace(const string_view json, string_view::size_type& pos) {
+    constexpr int shortRun = 8;
+    for(int i = 0; i < shortRun; i++) {
+        if(pos >= json.size() || !isWhitespace(json[pos])) return;
+        pos++;
     }
-    return str;
+    pos = findNonWhitespace(json, pos);
 }
 
 /**
  *
- * @param str JSON string starting with object or array value
- * @param isObject true to skip an object, false for array
- * @return JSON string with the object or array value skipped
+ * @param json JSON string
+ * @param pos position of the number value, moved past it
  */
-string skipObjectOrArray(const string& str, const bool isObject) {
-    int stack = 1;
-    bool inString = false;  // track if we are inside a string literal
-    for (size_t i = 1; i < str.size(); ++i) {
-        const char c = str[i];
-        if (inString) {
-            if (c == '"') inString = false;
-            else if (c == '\\') i++; // skip the next escaped char
-        } else {
-            if (c == '"') {
-                inString = true;  // starting or ending a string literal
-            } else if (c == (isObject ? '{' : '[')) {
-                stack++;
-            } else if (c == (isObject ? '}' : ']')) {
-                stack--;
-                if (stack == 0) {
-                    return &str[++i];  // found the matching closing brace
-                }
-            }
-        }
-    }
-    throw JSONParseException("No matching closing brace found.");
+void skipNumber(const string_view json, string_view::size_type& pos) {
+    if(scanNumber(json, pos) == NOT_A_NUMBER) throw JSONParseException("Malformed number");
 }
 
 /**
  *
-* @param str JSON string starting with string value
- * @return JSON string with the string value skipped
+ * @param json JSON string
+ * @param pos position of the object or array value, moved past it
  */
-string skipString(const string& str) {
-    if(str[0] != '"') throw JSONParseException("Missing string opening quotation mark");
-    for(int i = 1; i < str.size(); i++) {
-        if(str[i] == '"') return &str[i+1];
-        if(str[i] == '\\') i++;
-    }
-    throw JSONParseException("Cant skip");
+void skipObjectOrArray(const string_view json, string_view::size_type& pos) {
+    const string_view::size_type end = findContainerEnd(json, pos + 1);
+    if(end == string_view::npos) throw JSONParseException("No matching closing brace found.");
+    pos = end + 1;
 }
 
 /**
  *
- * @param str JSON string starting with value
- * @return JSON string with the value skipped
+ * @param json JSON string
+ * @param pos position of the string value, moved past its closing quotation mark
  */
-string skipValue(const string& str) {
-    switch (str[0]) {
-        case '"': return skipString(str);
+void skipString(const string_view json, string_view::size_type& pos) {
+    if(peek(json, pos) != '"') throw JSONParseException("Missing string opening quotation mark");
+    const string_view::size_type end = findStringEnd(json, pos + 1);
+    if(end == string_view::npos) throw JSONParseException("Cant skip");
+    pos = end + 1;
+}
+
+/**
+ *
+ * @param json JSON string
+ * @param pos position of the value, moved past it
+ */
+void skipValue(const string_view json, string_view::size_type& pos) {
+    switch (peek(json, pos)) {
+        case '"': return skipString(json, pos);
         case 'n':
-        case 't': return &str[4];
-        case 'f': return &str[5];
+        case 't': pos += 4; return;
+        case 'f': pos += 5; return;
         case '-':case '0':case '1':case '2':case '3':case '4':
-        case '5':case '6':case '7':case '8':case '9': return skipNumber(str);
-        case '{': return skipObjectOrArray(str, true);
-        case '[': return skipObjectOrArray(str, false);
+        case '5':case '6':case '7':case '8':case '9': return skipNumber(json, pos);
+        case '{':
+        case '[': return skipObjectOrArray(json, pos);
         default: throw JSONParseException("Error while skipping value");
     }
 }
 
 /**
- * Extracts a string
- * 
- * @param json string that contains a string to be parsed in front,
- * the wanted string should be surrounded with "
- * @return the extracted string
+ * Reads the 4 hexadecimal digits of a unicode escape sequence
+ *
+ * @param json JSON string
+ * @param pos position of 4 hexadecimal digits, moved past them
+ * @return value of the digits
+ */
+unsigned parseHex4(const string_view json, string_view::size_type& pos) {
+    if(json.size() - pos < 4) throw JSONParseException("Reached EOF while parsing string");
+    unsigned value = 0;
+    for(int j = 0; j < 4; j++) {
+        const char h = json[pos++];
+        value <<= 4;
+        if(h >= '0' && h <= '9') value |= h - '0';
+        else if(h >= 'a' && h <= 'f') value |= h - 'a' + 10;
+        else if(h >= 'A' && h <= 'F') value |= h - 'A' + 10;
+        else throw JSONParseException("Error while parsing universal character name");
+    }
+    return value;
+}
+
+/**
+ * Appends the code point encoded as UTF-8
+ *
+ * @param result string to append to
+ * @param codePoint unicode code point
  */
-string parseString(const string& json) {
-    if(json[0] != '"') throw JSONParseException("Missing key opening quotation mark '\"'");
-    stringstream result;
-    for(int i = 1; i < json.size(); i++) {
-        if(json[i] == '"') return result.str();
-
-        // escaped character or escape sequence
-        if(json[i] == '\\') {
-            i++;
-            if(i == json.size()) throw JSONParseException("Reached EOF while parsing string");
-            switch(const char c = json[i]) {
-                case '\\':
-                case '/':
-                case '"':
-                    result << c;
-                    break;
-                case 'b':
-                    result << '\b';
-                    break;
-                case 'f':
-                    result << '\f';
-                    break;
-                case 'n':
-                    result << '\n';
-                    break;
-                case 'r':
-                    result << '\r';
-                    break;
-                case 't':
-                    result << '\t';
-                    break;
-                case 'u': {
-                    stringstream ss;
-                    for(int j = 0; j < 4; j++) {
-                        i++;
-                        if(i == json.size()) throw JSONParseException("Reached EOF while parsing string");
-                        const char h = json[i];
-                        ss << hex << h;
-                    }
-                    if(int j; ss >> j)
-                        result << static_cast<char>(j);
-                    else throw JSONParseException("Error while parsing universal character name");
-                    break;
-                }
-                default: throw JSONParseException("Unexpected escape sequence");
+template<typename S>
+void appendUTF8(S& result, const unsigned codePoint) {
+    if(codePoint < 0x80) {
+        result += static_cast<char>(codePoint);
+    } else if(codePoint < 0x800) {
+        result += static_cast<char>(0xC0 | codePoint >> 6);
+        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if(codePoint < 0x10000) {
+        result += static_cast<char>(0xE0 | codePoint >> 12);
+        result += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        result += static_cast<char>(0xF0 | codePoint >> 18);
+        result += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+        result += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+/**
+ * Decodes the escape sequence after a backslash
+ *
+ * @param json JSON string
+ * @param pos position after the backslash, moved past the escape sequence
+ * @param result string to append the decoded character to
+ */
+template<typename S>
+void parseEscape(const string_view json, string_view::size_type& pos, S& result) {
+    if(pos == json.size()) throw JSONParseException("Reached EOF while parsing string");
+    switch(const char c = json[pos++]) {
+        case '\\':
+        case '/':
+        case '"':
+            result += c;
+            break;
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'u': {
+            unsigned codePoint = parseHex4(json, pos);
+            if(codePoint >= 0xDC00 && codePoint <= 0xDFFF) throw JSONParseException("Unpaired low surrogate");
+            if(codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                // high surrogate, has to be followed by an escaped low surrogate
+                if(json.substr(pos, 2) != "\\u") throw JSONParseException("Unpaired high surrogate");
+                pos += 2;
+                const unsigned low = parseHex4(json, pos);
+                if(low < 0xDC00 || low > 0xDFFF) throw JSONParseException("Unpaired high surrogate");
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
             }
+            appendUTF8(result, codePoint);
+            break;
+        }
+        default: throw JSONParseException("Unexpected escape sequence");
+    }
+}
+
+/**
+ * Decodes a string and appends it. Runs without escape sequences are found with the structural index
+ * and copied at once
+ *
+ * @param json JSON string
+ * @param pos position of the string to be parsed, the wanted string should be surrounded with ".
+ * Moved past the closing quotation mark
+ * @param result string to append to
+ */
+template<typename S>
+void appendString(const string_view json, string_view::size_type& pos, S& result) {
+    if(peek(json, pos) != '"') throw JSONParseException("Missing key opening quotation mark '\"'");
+    string_view::size_type i = pos + 1;
+    while(true) {
+        const string_view::size_type special = findQuoteOrBackslash(json, i);
+        if(special == string_view::npos) throw JSONParseException("Missing string closing quotation mark '\"'");
+        result.append(json.data() + i, special - i);
+        if(json[special] == '"') {
+            pos = special + 1;
+            return;
         }
+        i = special + 1;
+        parseEscape(json, i, result);
+    }
+}
 
-        else result << json[i];
+/**
+ * Extracts a string, strings without escape sequences are taken straight from the JSON, the rest is decoded
+ *
+ * @param json JSON string
+ * @param pos position of the string to be parsed, the wanted string should be surrounded with ".
+ * Moved past the closing quotation mark
+ * @param decoded storage of the string if it has escape sequences
+ * @return the extracted string, valid as long as json and decoded
+ */
+string_view parseString(const string_view json, string_view::size_type& pos, string& decoded) {
+    if(peek(json, pos) != '"') throw JSONParseException("Missing key opening quotation mark '\"'");
+    if(const string_view::size_type end = findQuoteOrBackslash(json, pos + 1);
+        end != string_view::npos && json[end] == '"') {
+        const string_view text = json.substr(pos + 1, end - pos - 1);
+        pos = end + 1;
+        return text;
     }
-    throw JSONParseException("Missing string closing quotation mark '\"'");
+    appendString(json, pos, decoded);
+    return decoded;
 }
 
 /**
  *
- * @param json JSON string with array in front
+ * @param json JSON string
+ * @param pos position of the array, moved past its closing bracket
+ * @param filter needed part of the items, nullptr parses everything
+ * @param resource memory resource the items are allocated from
+ * @param keys dictionary the keys of nested objects are interned in, nullptr if they own their characters
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
  * @return vector representation of the JSON array value
  */
-vector<ValueJSON> parseArray(string json) { // NOLINT(*-no-recursion)
-    vector<ValueJSON> result;
-    json = skip(json, 1);
-    while(json[0] != ']') {
-        result.push_back(parseValue(json));
-        json = skipValue(json);
-        if(json[0] == ',') {
-            json = skip(json, 1);
-            if(json[0] == ']') throw JSONParseException("Unexpected ',' after last value");
-        } else if(json[0] != ']') {
+ArrayJSON parseArray(const string_view json, string_view::size_type& pos, // NOLINT(*-no-recursion)
+                     const PathFilter* filter, pmr::memory_resource* resource, KeysJSON* keys, const bool borrow) {
+    // every item is kept so that subscripts and size stay correct
+    const PathFilter* itemFilter = filter == nullptr ? nullptr
+                                   : filter->items != nullptr ? filter->items.get() : &typeOnly;
+    ArrayJSON result(resource);
+    pos++;
+    skipWhitespace(json, pos);
+    while(peek(json, pos) != ']') {
+        result.push_back(parseValue(json, pos, itemFilter, resource, keys, borrow));
+        skipWhitespace(json, pos);
+        if(peek(json, pos) == ',') {
+            pos++;
+            skipWhitespace(json, pos);
+            if(peek(json, pos) == ']') throw JSONParseException("Unexpected ',' after last value");
+        } else if(peek(json, pos) != ']') {
             throw JSONParseException("Error: missing ',' after value");
         }
     }
+    pos++;
     return result;
 }
 
+/**
+ * Checks that the literal is at pos and moves past it
+ *
+ * @param json JSON string
+ * @param pos position of the literal
+ * @param literal expected literal (null, true, false)
+ */
+inline void parseLiteral(const string_view json, string_view::size_type& pos, const string_view literal) {
+    if(json.substr(pos, literal.size()) != literal) throw JSONParseException("Unexpected value type");
+    pos += literal.size();
+}
+
 /**
  * Parses string JSON value into ValueJSON type
  *
- * @param json string with value to parse in front
+ * @param json JSON string
+ * @param pos position of the value to parse, moved past it
+ * @param filter needed part of the value, nullptr parses everything
+ * @param resource memory resource strings, objects and arrays are allocated from
+ * @param keys dictionary the keys of objects are interned in, nullptr if they own their characters
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
  * @return parsed value
  */
-ValueJSON parseValue(const string& json) { // NOLINT(*-no-recursion)
-    ValueJSON value;
-    switch(json[0]) {
+ValueJSON parseValue(const string_view json, string_view::size_type& pos, // NOLINT(*-no-recursion)
+                     const PathFilter* filter, pmr::memory_resource* resource, KeysJSON* keys, const bool borrow) {
+    if(filter != nullptr && filter->everything) filter = nullptr;
+    switch(peek(json, pos)) {
         case 'n': {
-            if(json.size() >= 4 && json[1] == 'u' && json[2] == 'l' && json[3] == 'l') {
-                value.type = typeNULL;
-                break;
-            }
-            throw JSONParseException("Unexpected value type");
+            parseLiteral(json, pos, "null");
+            return {};
         }
         case '"': {
-            value.type = STRING;
-            value.value = parseString(json);
-            break;
-        }
-        case '{': {
-            value.type = OBJECT;
-            value.value = parseObject(json);
-            break;
-        }
-        case '[': {
-            value.type = ARRAY;
-            value.value = parseArray(json);
-            break;
+            string decoded;
+            const string_view text = parseString(json, pos, decoded);
+            // decoded strings live only in decoded, they are copied like when not borrowing
+            if(borrow && decoded.empty()) return ValueJSON::borrow(text);
+            return ValueJSON(text, resource);
         }
+        case '{': return ValueJSON(parseObject(json, pos, filter, resource, keys, borrow));
+        case '[': return ValueJSON(parseArray(json, pos, filter, resource, keys, borrow));
         case 't': {
-            if(json.size() >= 4 && json[1] == 'r' && json[2] == 'u' && json[3] == 'e') {
-                value.type = BOOL;
-                value.value = true;
-                break;
-            }
-            throw JSONParseException("Unexpected value type");
+            parseLiteral(json, pos, "true");
+            return ValueJSON(true);
         }
         case 'f': {
-            if(json.size() >= 5 && json[1] == 'a' && json[2] == 'l' && json[3] == 's' && json[4] == 'e') {
-                value.type = BOOL;
-                value.value = false;
-                break;
-            }
-            throw JSONParseException("Unexpected value type");
+            parseLiteral(json, pos, "false");
+            return ValueJSON(false);
         }
         case '-':
-            if(json.size() < 2 || !isdigit(json[1])) throw JSONParseException("Negative sign should be followed by a number");
+            if(!isdigit(peek(json, pos + 1))) throw JSONParseException("Negative sign should be followed by a number");
         // falls through if there is a digit after -
         case '0':case '1':case '2':case '3':case '4':
         case '5':case '6':case '7':case '8':case '9': {
-            size_t intPos;
-            size_t floatPos;
-
-            long long intNumber = stoll(json, &intPos);
-            double floatNumber = stod(json, &floatPos);
-            // if intPos == floatPos then there was no fraction part which means it's an integer
-            if(intPos == floatPos) {
-                value.type = INT;
-                value.value = intNumber;
-            } else {
-                value.type = FLOAT;
-                value.value = floatNumber;
+            long long integer;
+            double floating;
+            switch(parseNumber(json, pos, integer, floating)) {
+                case INTEGER_NUMBER: return ValueJSON(integer);
+                case FLOAT_NUMBER: return ValueJSON(floating);
+                case NOT_A_NUMBER: break;
             }
-            break;
+            throw JSONParseException("Malformed number");
         }
 
         default: throw JSONParseException("Unexpected value type");
     }
-    return value;
 }
 
 /**
@@ -299,7 +366,7 @@ ValueJSON parseValue(const string& json) { // NOLINT(*-no-recursion)
  * @param key string key
  * @return true if valid, false otherwise
  */
-inline bool isKeyValid(const string& key) {
+inline bool isKeyValid(const string_view key) {
     if(key.empty()) return false;
     // check if the first character is a letter
     if(const char c = key[0];
@@ -312,52 +379,561 @@ inline bool isKeyValid(const string& key) {
     return true;
 }
 
+/**
+ * Parses an object key together with the ':' after it
+ *
+ * @param json JSON string
+ * @param pos position of the key, moved to the start of the value
+ * @param resource memory resource the key is allocated from if it is not interned
+ * @param keys dictionary the key is interned in, nullptr if the key owns its characters
+ * @return the key
+ */
+KeyJSON parseKey(const string_view json, string_view::size_type& pos, pmr::memory_resource* resource,
+                 KeysJSON* keys) {
+    string decoded;
+    const string_view text = parseString(json, pos, decoded);
+    if(!isKeyValid(text)) throw JSONParseException(("Invalid key syntax for key " + string(text)).c_str());
+    skipWhitespace(json, pos);
+    if(peek(json, pos) != ':') throw JSONParseException("Missing ':' between key and value");
+    pos++;
+    skipWhitespace(json, pos);
+    return keys != nullptr ? keys->intern(text) : KeyJSON(text, resource);
+}
+
 /**
  * Parses JSON object into a hashmap
  *
- * @param json JSON object string
+ * @param json JSON string
+ * @param pos position of the object, moved past its closing curly brace
+ * @param filter needed members, the rest is skipped. nullptr parses everything
+ * @param resource memory resource the members are allocated from
+ * @param keys dictionary the keys are interned in, nullptr if they own their characters
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
  * @return hashmap representation of the JSON object
  */
-unordered_map<string, ValueJSON> parseObject(string json) { // NOLINT(*-no-recursion)
-    unordered_map<string, ValueJSON> object;
-    if(json[0] != '{') throw JSONParseException("Missing object opening curly brace '{'");
-    json = skip(json, 1);
-    while(json[0] != '}') {
-        // get key
-        const string key = parseString(json);
-        if(!isKeyValid(key)) throw JSONParseException(("Invalid key syntax for key " + key).c_str());
-        json = skipString(json);
-        if(json[0] != ':') throw JSONParseException("Missing ':' between key and value");
-        json = skip(json, 1);
-        // get value, try to insert while checking for key uniqueness
-        if(ValueJSON value = parseValue(json); !object.insert({key, value}).second)
-            throw JSONParseException("Duplicate keys");
-        json = skipValue(json);
-        if(json[0] == ',') { // another entry expected
-            json = skip(json, 1);
-            if(json[0] == '}') throw JSONParseException("Unexpected ',' after last value");
-        } else if(json[0] != '}') { // if no entry expected, expect a closing bracket
-            const string message = "Key: " + key + " Error: missing ',' after value";
+ObjectJSON parseObject(const string_view json, string_view::size_type& pos, // NOLINT(*-no-recursion)
+                       const PathFilter* filter, pmr::memory_resource* resource, KeysJSON* keys, const bool borrow) {
+    ObjectJSON object(resource);
+    if(peek(json, pos) != '{') throw JSONParseException("Missing object opening curly brace '{'");
+    pos++;
+    skipWhitespace(json, pos);
+    while(peek(json, pos) != '}') {
+        KeyJSON key = parseKey(json, pos, resource, keys);
+        string_view name = key; // the key is moved into the object, name stays valid for error messages
+        const PathFilter* memberFilter = nullptr;
+        if(filter != nullptr) {
+            const auto member = filter->members.find(key);
+            memberFilter = member != filter->members.end() ? &member->second : nullptr;
+        }
+        if(filter == nullptr || memberFilter != nullptr) {
+            // get value, try to insert while checking for key uniqueness
+            ValueJSON value = parseValue(json, pos, memberFilter, resource, keys, borrow);
+            const auto [member, inserted] = object.try_emplace(std::move(key), std::move(value));
+            if(!inserted) throw JSONParseException("Duplicate keys");
+            name = member->first;
+        } else {
+            skipValue(json, pos);
+        }
+        skipWhitespace(json, pos);
+        if(peek(json, pos) == ',') { // another entry expected
+            pos++;
+            skipWhitespace(json, pos);
+            if(peek(json, pos) == '}') throw JSONParseException("Unexpected ',' after last value");
+        } else if(peek(json, pos) != '}') { // if no entry expected, expect a closing bracket
+            const string message = "Key: " + string(name) + " Error: missing ',' after value";
             throw JSONParseException(message.c_str());
         }
     }
+    pos++;
     return object;
 }
 
+// keys of an object on the tape with the indices of their words
+using TapeKeys = vector<pair<string_view, uint32_t>>;
+
+void parseTapeValue(string_view json, string_view::size_type& pos, TapeBuffers& tape, TapeKeys& keys);
+
+/**
+ * Appends a string to the string buffer of the tape
+ *
+ * @param json JSON string
+ * @param pos position of the string, moved past its closing quotation mark
+ * @param tape tape to append to
+ * @return string word of the tape
+ */
+uint64_t parseTapeString(const string_view json, string_view::size_type& pos, TapeBuffers& tape) {
+    const string::size_type offset = tape.strings.size();
+    tape.strings.append(sizeof(uint32_t), '\0');
+    appendString(json, pos, tape.strings);
+    const string::size_type length = tape.strings.size() - offset - sizeof(uint32_t);
+    if(length > UINT32_MAX) throw JSONParseException("String too long for the tape");
+    const auto length32 = static_cast<uint32_t>(length);
+    memcpy(tape.strings.data() + offset, &length32, sizeof(length32));
+    return TapeJSON::word(TAPE_STRING, offset);
+}
+
+/**
+ * Fills in the start word of a container once its end is known and appends the end word
+ *
+ * @param tape tape being built
+ * @param start index of the start word
+ * @param tag type of the container
+ * @param endTag type of the end word
+ * @param count number of members or items
+ */
+void closeTapeContainer(TapeBuffers& tape, const size_t start, const TapeTag tag, const TapeTag endTag, const uint64_t count) {
+    const size_t end = tape.words.size();
+    if(end > TapeJSON::INDEX_MASK) throw JSONParseException("JSON too big for the tape");
+    tape.words[start] = TapeJSON::word(tag, min(count, TapeJSON::COUNT_SATURATED) << 32 | end);
+    tape.words.push_back(TapeJSON::word(endTag, start));
+}
+
 /**
+ * Throws if an object on the tape has a key more than once, indexes the keys of wide objects
  *
- * @param filePath file path of the JSON to parse
- * @return hashmap representation of the JSON file
+ * @param tape tape with the whole object
+ * @param start index of the object start word
+ * @param count number of members
+ * @param keys scratch space for the keys
  */
-unordered_map<std::string, ValueJSON> parseFileJSON(const string& filePath) {
-    string json = openFile(filePath);
-    erase_if(json, [](const unsigned char c){return iswspace(c);});
-    if(json.size() < 2) throw JSONParseException("JSON file is less than 2 characters");
-    return parseObject(json);
-}
-
-unordered_map<std::string, ValueJSON> parseJSON(string json) {
-    erase_if(json, [](const unsigned char c){return iswspace(c);});
-    if(json.size() < 2) throw JSONParseException("JSON file is less than 2 characters");
-    return parseObject(json);
-}
\ No newline at end of file
+void checkTapeKeys(TapeBuffers& tape, const size_t start, const uint64_t count, TapeKeys& keys) {
+    keys.clear();
+    const TapeJSON view = tape.view();
+    const size_t end = view.containerEnd(start);
+    for(size_t i = start + 1; i < end; i = TapeRef(view, i + 1).next().index()) {
+        keys.emplace_back(view.stringAt(view.payload(i)), i);
+    }
+    ranges::sort(keys);
+    const auto duplicate = ranges::adjacent_find(keys, {}, &TapeKeys::value_type::first);
+    if(duplicate != keys.end()) throw JSONParseException("Duplicate keys");
+    // the offset has to fit next to the start index in the end word, objects past that are walked
+    const size_t offset = tape.keyIndex.size() + 1;
+    if(count < TapeJSON::INDEXED_MEMBERS || count >= TapeJSON::COUNT_SATURATED || offset >= TapeJSON::COUNT_SATURATED) return;
+    for(const auto& [key, word] : keys) tape.keyIndex.push_back(word);
+    tape.words[end] |= offset << 32;
+}
+
+/**
+ *
+ * @param json JSON string
+ * @param pos position of the object, moved past its closing curly brace
+ * @param tape tape to append to
+ * @param keys scratch space for checking the keys
+ */
+void parseTapeObject(const string_view json, string_view::size_type& pos, TapeBuffers& tape, // NOLINT(*-no-recursion)
+                     TapeKeys& keys) {
+    if(peek(json, pos) != '{') throw JSONParseException("Missing object opening curly brace '{'");
+    const size_t start = tape.words.size();
+    tape.words.push_back(0);
+    uint64_t count = 0;
+    pos++;
+    skipWhitespace(json, pos);
+    while(peek(json, pos) != '}') {
+        const string::size_type keyOffset = tape.strings.size();
+        tape.words.push_back(parseTapeString(json, pos, tape));
+        if(const string_view key = tape.view().stringAt(keyOffset); !isKeyValid(key))
+            throw JSONParseException(("Invalid key syntax for key " + string(key)).c_str());
+        skipWhitespace(json, pos);
+        if(peek(json, pos) != ':') throw JSONParseException("Missing ':' between key and value");
+        pos++;
+        skipWhitespace(json, pos);
+        parseTapeValue(json, pos, tape, keys);
+        count++;
+        skipWhitespace(json, pos);
+        if(peek(json, pos) == ',') {
+            pos++;
+            skipWhitespace(json, pos);
+            if(peek(json, pos) == '}') throw JSONParseException("Unexpected ',' after last value");
+        } else if(peek(json, pos) != '}') {
+            throw JSONParseException("Error: missing ',' after value");
+        }
+    }
+    pos++;
+    closeTapeContainer(tape, start, TAPE_OBJECT, TAPE_OBJECT_END, count);
+    if(count > 1) checkTapeKeys(tape, start, count, keys);
+}
+
+/**
+ *
+ * @param json JSON string
+ * @param pos position of the array, moved past its closing bracket
+ * @param tape tape to append to
+ * @param keys scratch space for checking the keys of objects
+ */
+void parseTapeArray(const string_view json, string_view::size_type& pos, TapeBuffers& tape, // NOLINT(*-no-recursion)
+                    TapeKeys& keys) {
+    const size_t start = tape.words.size();
+    tape.words.push_back(0);
+    uint64_t count = 0;
+    pos++;
+    skipWhitespace(json, pos);
+    while(peek(json, pos) != ']') {
+        parseTapeValue(json, pos, tape, keys);
+        count++;
+        skipWhitespace(json, pos);
+        if(peek(json, pos) == ',') {
+            pos++;
+            skipWhitespace(json, pos);
+            if(peek(json, pos) == ']') throw JSONParseException("Unexpected ',' after last value");
+        } else if(peek(json, pos) != ']') {
+            throw JSONParseException("Error: missing ',' after value");
+        }
+    }
+    pos++;
+    closeTapeContainer(tape, start, TAPE_ARRAY, TAPE_ARRAY_END, count);
+}
+
+/**
+ * Appends the words of a value to the tape
+ *
+ * @param json JSON string
+ * @param pos position of the value to parse, moved past it
+ * @param tape tape to append to
+ * @param keys scratch space for checking the keys of objects
+ */
+void parseTapeValue(const string_view json, string_view::size_type& pos, TapeBuffers& tape, // NOLINT(*-no-recursion)
+                    TapeKeys& keys) {
+    switch(peek(json, pos)) {
+        case 'n':
+            parseLiteral(json, pos, "null");
+            tape.words.push_back(TapeJSON::word(TAPE_NULL, 0));
+            return;
+        case 't':
+            parseLiteral(json, pos, "true");
+            tape.words.push_back(TapeJSON::word(TAPE_TRUE, 0));
+            return;
+        case 'f':
+            parseLiteral(json, pos, "false");
+            tape.words.push_back(TapeJSON::word(TAPE_FALSE, 0));
+            return;
+        case '"':
+            tape.words.push_back(parseTapeString(json, pos, tape));
+            return;
+        case '{':
+            return parseTapeObject(json, pos, tape, keys);
+        case '[':
+            return parseTapeArray(json, pos, tape, keys);
+        case '-':
+            if(!isdigit(peek(json, pos + 1))) throw JSONParseException("Negative sign should be followed by a number");
+            [[fallthrough]]; // if there is a digit after -
+        case '0':case '1':case '2':case '3':case '4':
+        case '5':case '6':case '7':case '8':case '9': {
+            long long integer;
+            double floating;
+            switch(parseNumber(json, pos, integer, floating)) {
+                case INTEGER_NUMBER:
+                    tape.words.push_back(TapeJSON::word(TAPE_INT, 0));
+                    tape.words.push_back(static_cast<uint64_t>(integer));
+                    return;
+                case FLOAT_NUMBER:
+                    tape.words.push_back(TapeJSON::word(TAPE_FLOAT, 0));
+                    tape.words.push_back(bit_cast<uint64_t>(floating));
+                    return;
+                case NOT_A_NUMBER: break;
+            }
+            throw JSONParseException("Malformed number");
+        }
+        default: throw JSONParseException("Unexpected value type");
+    }
+}
+
+// consecutive members of an object or items of an array (with empty keys)
+using MembersJSON = vector<pair<KeyJSON, ValueJSON>>;
+
+// hands out the memory resource of the next batch, called on the thread splitting the JSON
+using BatchResources = function<pmr::memory_resource*()>;
+
+/**
+ * Object or array being parsed in parallel, cut into batches of members in source order
+ */
+struct SplitJSON {
+    bool isObject = true;
+    struct Part {
+        future<MembersJSON> batch;
+        // a member big enough to be split itself instead of being part of a batch
+        KeyJSON key;
+        unique_ptr<SplitJSON> nested;
+    };
+    vector<Part> parts;
+};
+
+/**
+ * Parses a batch of members, the comma separated part of an object or array from pos until end
+ *
+ * @param json JSON string
+ * @param pos position of the first member
+ * @param end position right after the last value of the batch
+ * @param isObject true for object members, false for array items
+ * @param resource memory resource the members are allocated from, used by this batch only
+ * @param keys dictionary of this batch the keys are interned in, nullptr if they own their characters
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
+ * @return parsed members
+ */
+MembersJSON parseMembers(const string_view json, string_view::size_type pos, const string_view::size_type end,
+                         const bool isObject, pmr::memory_resource* resource, KeysJSON* keys, const bool borrow) {
+    MembersJSON members;
+    while(true) {
+        KeyJSON key = isObject ? parseKey(json, pos, resource, keys) : KeyJSON();
+        ValueJSON value = parseValue(json, pos, nullptr, resource, keys, borrow);
+        members.emplace_back(std::move(key), std::move(value));
+        if(pos >= end) return members;
+        skipWhitespace(json, pos);
+        if(peek(json, pos) != ',') throw JSONParseException("Error: missing ',' after value");
+        pos++;
+        skipWhitespace(json, pos);
+    }
+}
+
+/**
+ * Cuts an object or array into batches of at least threshold bytes and submits them to the pool.
+ * Members of the top-level object that are big objects or arrays are split as well
+ *
+ * @param json JSON string
+ * @param pos position of the object or array, moved past it
+ * @param pool pool parsing the batches
+ * @param threshold minimum size of a batch in bytes
+ * @param resources memory resources of the batches
+ * @param intern if true every batch interns its keys in a dictionary on its memory resource
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
+ * @param depth 0 for the top-level object
+ * @return the batches in source order
+ */
+unique_ptr<SplitJSON> splitContainer(const string_view json, string_view::size_type& pos, // NOLINT(*-no-recursion)
+                                     ThreadPool& pool, const string_view::size_type threshold,
+                                     const BatchResources& resources, const bool intern, const bool borrow,
+                                     const int depth) {
+    auto split = make_unique<SplitJSON>();
+    const bool isObject = peek(json, pos) == '{';
+    const char closing = isObject ? '}' : ']';
+    split->isObject = isObject;
+    string_view::size_type batchStart = string_view::npos;
+    string_view::size_type batchEnd = 0;
+    const auto submitBatch = [&] {
+        if(batchStart == string_view::npos) return;
+        split->parts.push_back({pool.submit([json, batchStart, batchEnd, isObject, intern, borrow, resource = resources()] {
+            KeysJSON keys(resource); // dictionaries are not thread safe, the batches do not share one
+            return parseMembers(json, batchStart, batchEnd, isObject, resource, intern ? &keys : nullptr, borrow);
+        }), {}, nullptr});
+        batchStart = string_view::npos;
+    };
+    pos++;
+    skipWhitespace(json, pos);
+    while(peek(json, pos) != closing) {
+        const string_view::size_type memberStart = pos;
+        if(isObject) { // the key is parsed with the batch, only nested containers need it here
+            skipString(json, pos);
+            skipWhitespace(json, pos);
+            if(peek(json, pos) != ':') throw JSONParseException("Missing ':' between key and value");
+            pos++;
+            skipWhitespace(json, pos);
+        }
+        string_view::size_type valueStart = pos;
+        skipValue(json, pos);
+        if(const char c = json[valueStart]; depth == 0 && pos - valueStart >= threshold && (c == '{' || c == '[')) {
+            submitBatch();
+            string_view::size_type keyPos = memberStart;
+            KeyJSON key = isObject ? parseKey(json, keyPos, pmr::get_default_resource(), nullptr) : KeyJSON();
+            split->parts.push_back({{}, std::move(key), splitContainer(json, valueStart, pool, threshold,
+                                                                       resources, intern, borrow, depth + 1)});
+        } else {
+            if(batchStart == string_view::npos) batchStart = memberStart;
+            batchEnd = pos;
+            if(batchEnd - batchStart >= threshold) submitBatch();
+        }
+        skipWhitespace(json, pos);
+        if(peek(json, pos) == ',') {
+            pos++;
+            skipWhitespace(json, pos);
+            if(peek(json, pos) == closing) throw JSONParseException("Unexpected ',' after last value");
+        } else if(peek(json, pos) != closing) {
+            throw JSONParseException("Error: missing ',' after value");
+        }
+    }
+    submitBatch();
+    pos++;
+    return split;
+}
+
+/**
+ * Waits for the batches of a split object or array and puts them together
+ *
+ * @param split object or array cut into batches
+ * @param pool pool parsing the batches
+ * @param resource memory resource the object or array is allocated from, the batches keep their own
+ * @return the parsed object or array
+ */
+ValueJSON joinContainer(SplitJSON& split, ThreadPool& pool, pmr::memory_resource* resource) { // NOLINT(*-no-recursion)
+    if(split.isObject) {
+        ObjectJSON object(resource);
+        for(SplitJSON::Part& part : split.parts) {
+            if(part.nested != nullptr) {
+                if(!object.try_emplace(std::move(part.key), joinContainer(*part.nested, pool, resource)).second)
+                    throw JSONParseException("Duplicate keys");
+                continue;
+            }
+            for(auto& [key, value] : pool.wait(part.batch)) {
+                if(!object.try_emplace(std::move(key), std::move(value)).second)
+                    throw JSONParseException("Duplicate keys");
+            }
+        }
+        return ValueJSON(std::move(object));
+    }
+    ArrayJSON array(resource);
+    for(SplitJSON::Part& part : split.parts) {
+        if(part.nested != nullptr) {
+            array.push_back(joinContainer(*part.nested, pool, resource));
+            continue;
+        }
+        for(auto& [key, value] : pool.wait(part.batch)) {
+            array.push_back(std::move(value));
+        }
+    }
+    return ValueJSON(std::move(array));
+}
+
+/**
+ * Parses with multiple threads, see parseJSON(std::string_view, unsigned, std::string_view::size_type)
+ *
+ * @param json JSON object text
+ * @param threads number of threads parsing, more than 1
+ * @param threshold minimum size of a batch in bytes
+ * @param resource memory resource the split objects and arrays are allocated from
+ * @param resources memory resources of the batches
+ * @param intern if true the batches intern their keys, see splitContainer
+ * @param borrow if true strings without escape sequences are views into json, see ValueJSON::borrow
+ * @return hashmap representation of the JSON
+ */
+ObjectJSON parseParallel(const string_view json, const unsigned threads, const string_view::size_type threshold,
+                         pmr::memory_resource* resource, const BatchResources& resources, const bool intern,
+                         const bool borrow) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    if(peek(json, pos) != '{') throw JSONParseException("Missing object opening curly brace '{'");
+    // the calling thread parses as well while it waits for the batches
+    ThreadPool pool(threads - 1);
+    const unique_ptr<SplitJSON> split = splitContainer(json, pos, pool, threshold, resources, intern, borrow, 0);
+    return std::move(joinContainer(*split, pool, resource).asObject());
+}
+
+TapeJSON parseTapeJSON(const string_view json) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    TapeBuffers tape;
+    tape.words.reserve(json.size() / 8 + 16); // about one word per token
+    TapeKeys keys;
+    parseTapeObject(json, pos, tape, keys);
+    // the document is kept for many evaluations, give back what the estimate and the growth overshot
+    tape.words.shrink_to_fit();
+    tape.strings.shrink_to_fit();
+    tape.keyIndex.shrink_to_fit();
+    return TapeJSON(std::move(tape));
+}
+
+ObjectJSON parseFileJSON(const string& filePath, pmr::memory_resource* resource) {
+    const InputJSON input(filePath);
+    return parseJSON(input.view(), resource);
+}
+
+ObjectJSON parseFileJSON(const string& filePath, const unsigned threads) {
+    const InputJSON input(filePath);
+    return parseJSON(input.view(), threads);
+}
+
+ObjectJSON parseJSON(const string_view json, pmr::memory_resource* resource) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    return parseObject(json, pos, nullptr, resource, nullptr, false);
+}
+
+ObjectJSON parseJSON(const string_view json, KeysJSON& keys, const bool borrow) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    return parseObject(json, pos, nullptr, keys.resource(), &keys, borrow);
+}
+
+ObjectJSON parseJSON(const string_view json, const PathFilter& filter, pmr::memory_resource* resource) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    return parseObject(json, pos, filter.everything ? nullptr : &filter, resource, nullptr, false);
+}
+
+ObjectJSON parseJSON(const string_view json, const PathFilter& filter, KeysJSON& keys, const bool borrow) {
+    string_view::size_type pos = 0;
+    skipWhitespace(json, pos);
+    if(json.size() - pos < 2) throw JSONParseException("JSON file is less than 2 characters");
+    return parseObject(json, pos, filter.everything ? nullptr : &filter, keys.resource(), &keys, borrow);
+}
+
+ObjectJSON parseJSON(const string_view json, const unsigned threads, const string_view::size_type threshold) {
+    if(threads <= 1) return parseJSON(json);
+    return parseParallel(json, threads, threshold, pmr::get_default_resource(), pmr::get_default_resource, false, false);
+}
+
+// the arenas start with a block about the size of the JSON they hold, their values take a few times more
+constexpr size_t MIN_ARENA_SIZE = 1 << 12;
+
+DocumentJSON::DocumentJSON(const string_view json, const unsigned threads, const string_view::size_type threshold,
+                           const bool borrow) {
+    pmr::memory_resource* resource = addArena(max(json.size(), MIN_ARENA_SIZE));
+    if(threads <= 1) {
+        KeysJSON keys(resource);
+        setRoot(parseJSON(json, keys, borrow));
+        return;
+    }
+    // the batches are parsed on different threads and monotonic arenas are not thread safe
+    setRoot(parseParallel(json, threads, threshold, resource, [this, threshold] {
+        return addArena(max(threshold, MIN_ARENA_SIZE));
+    }, true, borrow));
+}
+
+DocumentJSON::DocumentJSON(const string_view json, const PathFilter& filter, const bool borrow) {
+    // most of the JSON is usually skipped
+    KeysJSON keys(addArena(MIN_ARENA_SIZE));
+    setRoot(parseJSON(json, filter, keys, borrow));
+}
+
+DocumentJSON::DocumentJSON(const string_view json, const unsigned threads, const string_view::size_type threshold)
+    : DocumentJSON(json, threads, threshold, false) {}
+
+DocumentJSON::DocumentJSON(const string_view json, const PathFilter& filter)
+    : DocumentJSON(json, filter, false) {}
+
+DocumentJSON::DocumentJSON(shared_ptr<const InputJSON> input, const unsigned threads,
+                           const string_view::size_type threshold)
+    : DocumentJSON(input->view(), threads, threshold, true) {
+    source = std::move(input);
+}
+
+DocumentJSON::DocumentJSON(shared_ptr<const InputJSON> input, const PathFilter& filter)
+    : DocumentJSON(input->view(), filter, true) {
+    source = std::move(input);
+}
+
+DocumentJSON::DocumentJSON(DocumentJSON&& other) noexcept
+    : source(std::move(other.source)), arenas(std::move(other.arenas)), rootObject(exchange(other.rootObject, nullptr)) {}
+
+DocumentJSON& DocumentJSON::operator=(DocumentJSON&& other) noexcept {
+    source = std::move(other.source);
+    arenas = std::move(other.arenas);
+    rootObject = exchange(other.rootObject, nullptr);
+    return *this;
+}
+
+pmr::memory_resource* DocumentJSON::addArena(const size_t initialSize) {
+    return arenas.emplace_back(make_unique<pmr::monotonic_buffer_resource>(initialSize, pmr::new_delete_resource())).get();
+}
+
+void DocumentJSON::setRoot(ObjectJSON&& root) {
+    pmr::memory_resource* resource = arenas.front().get();
+    void* memory = resource->allocate(sizeof(ObjectJSON), alignof(ObjectJSON));
+    rootObject = new(memory) ObjectJSON(std::move(root), resource);
+}
+
+const ObjectJSON& DocumentJSON::root() const {
+    return *rootObject;
+}
@@ -1,19 +1,200 @@
 #ifndef parseJSON_H
 #define parseJSON_H
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include "input.h"
+#include "tape.h"
 #include "value.h"
 
 /**
+ * Tree of the parts of a JSON an expression can reach, everything else is skipped while parsing
+ */
+struct PathFilter {
+    bool everything = false; // the whole value is needed
+    std::unordered_map<std::string, PathFilter, KeyHash, KeyEqual> members; // needed members if the value is an object
+    std::unique_ptr<PathFilter> items; // needed part of every item if the value is an array
+};
+
+/**
+ *
+ * @param filePath file path of the JSON to parse, "-" for stdin
+ * @param resource memory resource the values are allocated from
+ * @return hashmap representation of the JSON file
+ */
+ObjectJSON parseFileJSON(const std::string& filePath,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * Parses with multiple threads, see parseJSON(std::string_view, unsigned, std::string_view::size_type)
  *
- * @param filePath file path of the JSON to parse
+ * @param filePath file path of the JSON to parse, "-" for stdin
+ * @param threads number of threads parsing
  * @return hashmap representation of the JSON file
  */
-std::unordered_map<std::string, ValueJSON> parseFileJSON(const std::string& filePath);
+ObjectJSON parseFileJSON(const std::string& filePath, unsigned threads);
+
+/**
+ *
+ * @param json JSON object text
+ * @param resource memory resource the values are allocated from
+ * @return hashmap representation of the JSON
+ */
+ObjectJSON parseJSON(std::string_view json, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * Interns the keys, objects of the same shape share their keys instead of each holding a copy
+ *
+ * @param json JSON object text
+ * @param keys dictionary the keys are interned in, the values are allocated from its memory resource
+ * @param borrow if true strings without escape sequences are views into json instead of copies,
+ * json then has to outlive the values. See ValueJSON::borrow
+ * @return hashmap representation of the JSON
+ */
+ObjectJSON parseJSON(std::string_view json, KeysJSON& keys, bool borrow = false);
+
+/**
+ * Parses only the values in the filter, other values are skipped without being materialized.
+ * Objects outside the filter are empty and arrays keep all their items with only their type
+ *
+ * @param json JSON object text
+ * @param filter parts of the JSON to parse
+ * @param resource memory resource the values are allocated from
+ * @return hashmap representation of the filtered JSON
+ */
+ObjectJSON parseJSON(std::string_view json, const PathFilter& filter,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * Parses only the values in the filter and interns the keys,
+ * see parseJSON(std::string_view, const PathFilter&, std::pmr::memory_resource*)
+ *
+ * @param json JSON object text
+ * @param filter parts of the JSON to parse
+ * @param keys dictionary the keys are interned in, the values are allocated from its memory resource
+ * @param borrow if true strings without escape sequences are views into json, see parseJSON(std::string_view, KeysJSON&, bool)
+ * @return hashmap representation of the filtered JSON
+ */
+ObjectJSON parseJSON(std::string_view json, const PathFilter& filter, KeysJSON& keys, bool borrow = false);
+
+/**
+ * Parses into a tape instead of a tree, see TapeJSON
+ *
+ * @param json JSON object text, not referenced after parsing
+ * @return tape of the JSON
+ */
+TapeJSON parseTapeJSON(std::string_view json);
 
-std::unordered_map<std::string, ValueJSON> parseJSON(std::string json);
+// default minimum size in bytes of the parts a JSON is cut into when parsing in parallel
+constexpr std::string_view::size_type PARALLEL_THRESHOLD = 1 << 20;
 
-std::string openFile(const std::string& filePath);
+/**
+ * Parses with multiple threads. The top-level object and its members that are big objects or arrays
+ * are cut into batches of members of at least threshold bytes, the batches are parsed on a thread pool
+ *
+ * @param json JSON object text
+ * @param threads number of threads parsing, 1 parses on the calling thread only
+ * @param threshold minimum size of a batch in bytes
+ * @return hashmap representation of the JSON
+ */
+ObjectJSON parseJSON(std::string_view json, unsigned threads,
+                     std::string_view::size_type threshold = PARALLEL_THRESHOLD);
+
+/**
+ * Parsed JSON that owns the memory of its values. The values are allocated from monotonic arenas,
+ * so parsing allocates by bumping a pointer and destroying the document frees a few big blocks
+ * without visiting the values. The keys are interned in a dictionary per arena.
+ * A document made from an input it keeps borrows its strings from the input instead of copying them
+ */
+class DocumentJSON {
+    std::shared_ptr<const InputJSON> source; // input the strings are views into, empty if they are copies
+    // one arena per batch parsed in parallel, the first one also holds the root object
+    std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas;
+    ObjectJSON* rootObject = nullptr; // never destroyed, everything it owns is in the arenas
+
+    /**
+     *
+     * @param initialSize size of the first block of the arena in bytes
+     * @return new arena owned by this document
+     */
+    std::pmr::memory_resource* addArena(std::size_t initialSize);
+
+    /**
+     * Moves the parsed object into the first arena
+     *
+     * @param root parsed object allocated from the document's arenas
+     */
+    void setRoot(ObjectJSON&& root);
+
+    /**
+     * @param json JSON object text
+     * @param threads number of threads parsing
+     * @param threshold minimum size of a batch in bytes when parsing in parallel
+     * @param borrow if true strings without escape sequences are views into json
+     */
+    DocumentJSON(std::string_view json, unsigned threads, std::string_view::size_type threshold, bool borrow);
+
+    /**
+     * @param json JSON object text
+     * @param filter parts of the JSON to parse
+     * @param borrow if true strings without escape sequences are views into json
+     */
+    DocumentJSON(std::string_view json, const PathFilter& filter, bool borrow);
+
+public:
+    /**
+     * Parses the JSON into a new document, see parseJSON(std::string_view, unsigned, std::string_view::size_type)
+     *
+     * @param json JSON object text, not referenced after parsing
+     * @param threads number of threads parsing
+     * @param threshold minimum size of a batch in bytes when parsing in parallel
+     */
+    explicit DocumentJSON(std::string_view json, unsigned threads = 1,
+                          std::string_view::size_type threshold = PARALLEL_THRESHOLD);
+
+    /**
+     * Parses only the values in the filter into a new document, see parseJSON(std::string_view, const PathFilter&)
+     *
+     * @param json JSON object text, not referenced after parsing
+     * @param filter parts of the JSON to parse
+     */
+    DocumentJSON(std::string_view json, const PathFilter& filter);
+
+    /**
+     * Parses the input into a new document that keeps it, strings without escape sequences are not copied
+     * but refer to the input. See DocumentJSON(std::string_view, unsigned, std::string_view::size_type)
+     *
+     * @param input JSON object text, kept as long as the document
+     * @param threads number of threads parsing
+     * @param threshold minimum size of a batch in bytes when parsing in parallel
+     */
+    explicit DocumentJSON(std::shared_ptr<const InputJSON> input, unsigned threads = 1,
+                         std::string_view::size_type threshold = PARALLEL_THRESHOLD);
+
+    /**
+     * Parses only the values in the filter into a new document that keeps the input,
+     * see DocumentJSON(std::shared_ptr<const InputJSON>, unsigned, std::string_view::size_type)
+     *
+     * @param input JSON object text, kept as long as the document
+     * @param filter parts of the JSON to parse
+     */
+    DocumentJSON(std::shared_ptr<const InputJSON> input, const PathFilter& filter);
+
+    DocumentJSON(DocumentJSON&& other) noexcept;
+    DocumentJSON& operator=(DocumentJSON&& other) noexcept;
+    DocumentJSON(const DocumentJSON&) = delete;
+    DocumentJSON& operator=(const DocumentJSON&) = delete;
+    ~DocumentJSON() = default;
+
+    /**
+     *
+     * @return the parsed JSON object
+     */
+    [[nodiscard]] const ObjectJSON& root() const;
+};
 
 class JSONParseException final : public std::exception {
     std::string message;
@@ -0,0 +1,215 @@
+#include "simplify.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <optional>
+
+#include "execute.h"
+
+using namespace std;
+
+inline bool isLiteral(const Node& node) {
+    return node.action == INT_LITERAL || node.action == FLOAT_LITERAL;
+}
+
+/**
+ *
+ * @param node expression node
+ * @return whether the node is a number whenever it evaluates without throwing
+ */
+inline bool isNumber(const Node& node) {
+    switch(node.action) {
+        case IDENTIFIER:
+        case GET_MEMBER:
+        case GET_SUBSCRIPT:
+        case ONLY_SUBSCRIPT: return false;
+        default: return true;
+    }
+}
+
+/**
+ *
+ * @param node expression node
+ * @return whether the node is an integer whenever it evaluates without throwing
+ */
+bool isInteger(const Node& node) { // NOLINT(*-no-recursion)
+    switch(node.action) {
+        case INT_LITERAL:
+        case SIZE:
+        case COUNT: return true;
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE: return node.children.size() == 2 && isInteger(node.children[0]) && isInteger(node.children[1]);
+        default: return false;
+    }
+}
+
+/**
+ *
+ * @param node expression node
+ * @return whether the node is a floating point number whenever it evaluates without throwing
+ */
+bool isFloat(const Node& node) { // NOLINT(*-no-recursion)
+    switch(node.action) {
+        case FLOAT_LITERAL:
+        case AVG:
+        case STDDEV: return true;
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE: return node.children.size() == 2 && (isFloat(node.children[0]) || isFloat(node.children[1]));
+        default: return false;
+    }
+}
+
+/**
+ *
+ * @param literal literal node
+ * @param number integer the literal should be
+ * @return whether the literal is the integer, a floating point literal is not
+ */
+inline bool isInteger(const Node& literal, const long long number) {
+    return literal.action == INT_LITERAL && get<long long>(literal.value) == number;
+}
+
+/**
+ *
+ * @param literal literal node
+ * @param number floating point number the literal should be, 0 only matches positive zero
+ * @return whether the literal is the floating point number, an integer literal is not
+ */
+inline bool isFloat(const Node& literal, const double number) {
+    return literal.action == FLOAT_LITERAL && get<double>(literal.value) == number
+           && signbit(get<double>(literal.value)) == signbit(number);
+}
+
+/**
+ * x * 1, 1 * x, x / 1 and x ^ 1 are x if an integer 1 keeps the type of x, a floating point 1 makes x floating point
+ *
+ * @param one possible literal 1
+ * @param operand other operand
+ * @return whether the operation gives back the operand
+ */
+inline bool isIdentityOne(const Node& one, const Node& operand) {
+    return (isInteger(one, 1) && isNumber(operand)) || (isFloat(one, 1.0) && isFloat(operand));
+}
+
+/**
+ * x - 0 is x, even for negative zero
+ *
+ * @param zero possible literal 0
+ * @param operand other operand
+ * @return whether the subtraction gives back the operand
+ */
+inline bool isIdentityZero(const Node& zero, const Node& operand) {
+    return (isInteger(zero, 0) && isNumber(operand)) || (isFloat(zero, 0.0) && isFloat(operand));
+}
+
+/**
+ * Negative zero plus zero is positive zero, only integers stay the same when adding 0
+ *
+ * @param zero possible literal 0
+ * @param operand other operand
+ * @return whether the addition gives back the operand
+ */
+inline bool isAdditiveZero(const Node& zero, const Node& operand) {
+    return isInteger(zero, 0) && isInteger(operand);
+}
+
+/**
+ * Applies the function or operator to its literal arguments once, with the code evaluating it
+ *
+ * @param node function or operator node with only literal children
+ * @return literal result, nothing if it would throw or divide an integer by zero
+ */
+optional<Node> fold(const Node& node) {
+    vector<ResultJSON> arguments;
+    arguments.reserve(node.children.size());
+    for(const Node& child : node.children) {
+        if(child.action == INT_LITERAL) arguments.emplace_back(ValueJSON(get<long long>(child.value)));
+        else arguments.emplace_back(ValueJSON(get<double>(child.value)));
+    }
+    if(node.action == DIVIDE && arguments.size() == 2 && arguments[0]->type == INT && arguments[1]->type == INT) {
+        const long long divisor = arguments[1]->asInt();
+        if(divisor == 0 || (divisor == -1 && arguments[0]->asInt() == LLONG_MIN)) return nullopt;
+    }
+    ValueJSON result;
+    try {
+        result = applyAction(node.action, arguments);
+    } catch (const executeException&) {
+        return nullopt;
+    }
+    if(result.type == INT) {
+        Node literal(INT_LITERAL);
+        literal.value = result.asInt();
+        return literal;
+    }
+    Node literal(FLOAT_LITERAL);
+    literal.value = result.asDouble();
+    return literal;
+}
+
+/**
+ * Simplifies the children and subscript first, so folded literals fold further up
+ *
+ * @param node node to simplify in place
+ */
+void simplify(Node& node) { // NOLINT(*-no-recursion)
+    if(node.subscript != nullptr) simplify(*node.subscript);
+    for(Node& child : node.children) simplify(child);
+    switch(node.action) {
+        case MAX:
+        case MIN:
+        case SIZE:
+        case SUM:
+        case AVG:
+        case COUNT:
+        case STDDEV:
+        case ADD:
+        case SUBTRACT:
+        case MULTIPLY:
+        case DIVIDE:
+        case RAISE: break;
+        default: return;
+    }
+    if(ranges::all_of(node.children, isLiteral)) {
+        if(optional<Node> literal = fold(node)) {
+            node = std::move(*literal);
+            return;
+        }
+    }
+    if(node.children.size() != 2) return;
+    Node& a = node.children[0];
+    Node& b = node.children[1];
+    Node* kept = nullptr;
+    switch(node.action) {
+        case MULTIPLY:
+            if(isIdentityOne(b, a)) kept = &a;
+            else if(isIdentityOne(a, b)) kept = &b;
+            break;
+        case DIVIDE:
+        case RAISE:
+            if(isIdentityOne(b, a)) kept = &a;
+            break;
+        case SUBTRACT:
+            if(isIdentityZero(b, a)) kept = &a;
+            break;
+        case ADD:
+            if(isAdditiveZero(b, a)) kept = &a;
+            else if(isAdditiveZero(a, b)) kept = &b;
+            break;
+        default: break;
+    }
+    if(kept == nullptr) return;
+    Node operand = std::move(*kept);
+    node = std::move(operand);
+}
+
+Node simplifyExpression(Node expression) {
+    simplify(expression);
+    return expression;
+}
@@ -0,0 +1,17 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+#include "expression.h"
+
+/**
+ * Folds functions and operators of only number literals into one literal, subscripts included,
+ * and removes operations that give back their other operand: x * 1, 1 * x, x / 1, x ^ 1, x - 0, x + 0 and 0 + x.
+ * An operation is removed only if its operand is known to be a number of the right type,
+ * a path could be a string that makes the operator throw or an integer that the operator makes floating point.
+ * Operations that would throw or divide an integer by zero are kept so they fail when evaluated, like before
+ *
+ * @param expression expression parsed by parseExpression
+ * @return expression with the same results and errors, evaluated in fewer steps
+ */
+Node simplifyExpression(Node expression);
+
+#endif //SIMPLIFY_H
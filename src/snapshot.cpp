@@ -0,0 +1,162 @@
+#include "snapshot.h"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include "input.h"
+#include "parseJSON.h"
+
+using namespace std;
+
+constexpr char SNAPSHOT_MAGIC[8] = {'J', 'S', 'O', 'N', 'T', 'A', 'P', 'E'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304; // reads differently on a machine of the other endianness
+
+/**
+ * Start of a snapshot file, followed by the words, the key index and the strings in this order.
+ * A multiple of 8 bytes so the words after it stay aligned in the mapping
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    SourceStamp source;
+    uint64_t words;    // number of words
+    uint64_t keyIndex; // number of key index entries
+    uint64_t strings;  // bytes of the string buffer
+    uint64_t checksum; // of the words, the key index and the strings, see sectionsChecksum
+};
+
+static_assert(sizeof(SnapshotHeader) == 72);
+
+/**
+ *
+ * @param tape tape of a snapshot
+ * @return checksum of its words, key index and strings
+ */
+uint64_t sectionsChecksum(const TapeJSON& tape) {
+    const uint64_t words = hashBytes({reinterpret_cast<const char*>(tape.words.data()), tape.words.size_bytes()});
+    const uint64_t keyIndex = hashBytes({reinterpret_cast<const char*>(tape.keyIndex.data()), tape.keyIndex.size_bytes()});
+    return words ^ rotl(keyIndex, 21) ^ rotl(hashBytes(tape.strings), 42);
+}
+
+/**
+ *
+ * @param filePath file path of the JSON file
+ * @return its size and modification time, empty if they could not be read
+ */
+optional<SourceStamp> fileStamp(const string& filePath) {
+    error_code error;
+    const uintmax_t size = filesystem::file_size(filePath, error);
+    if(error) return nullopt;
+    const filesystem::file_time_type modified = filesystem::last_write_time(filePath, error);
+    if(error) return nullopt;
+    return SourceStamp{size, static_cast<int64_t>(modified.time_since_epoch().count()), 0};
+}
+
+uint64_t hashBytes(const string_view bytes) {
+    constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+    // four independent lanes so the multiplications overlap
+    uint64_t lanes[4] = {bytes.size(), 1, 2, 3};
+    string_view::size_type i = 0;
+    for(; i + sizeof(lanes) <= bytes.size(); i += sizeof(lanes)) {
+        for(int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            memcpy(&word, bytes.data() + i + lane * sizeof(word), sizeof(word));
+            lanes[lane] = rotl((lanes[lane] ^ word) * multiplier, 31);
+        }
+    }
+    uint64_t hash = lanes[0] ^ rotl(lanes[1], 16) ^ rotl(lanes[2], 32) ^ rotl(lanes[3], 48);
+    for(; i < bytes.size(); i++) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * multiplier;
+    }
+    return hash ^ hash >> 29;
+}
+
+string snapshotPath(const string& filePath) {
+    return filePath + ".snapshot";
+}
+
+bool writeSnapshot(const TapeJSON& tape, const SourceStamp& stamp, const string& path) {
+    SnapshotHeader header{};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.source = stamp;
+    header.words = tape.words.size();
+    header.keyIndex = tape.keyIndex.size();
+    header.strings = tape.strings.size();
+    header.checksum = sectionsChecksum(tape);
+
+    // unique per writer, several runs may write the snapshot of the same file at once
+    const string temporary = path + ".tmp" + to_string(random_device{}());
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        if(!out.good()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(tape.words.data()), static_cast<streamsize>(tape.words.size_bytes()));
+        out.write(reinterpret_cast<const char*>(tape.keyIndex.data()), static_cast<streamsize>(tape.keyIndex.size_bytes()));
+        out.write(tape.strings.data(), static_cast<streamsize>(tape.strings.size()));
+        out.close();
+        if(!out.good()) {
+            error_code error;
+            filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    error_code error;
+    filesystem::rename(temporary, path, error);
+    if(error) filesystem::remove(temporary, error);
+    return !error;
+}
+
+optional<TapeJSON> loadSnapshot(const string& path, const SourceStamp& stamp) {
+    if(error_code error; !filesystem::is_regular_file(path, error)) return nullopt;
+    shared_ptr<const InputJSON> file;
+    try {
+        file = make_shared<const InputJSON>(path);
+    } catch(const runtime_error&) {
+        return nullopt;
+    }
+    const string_view bytes = file->view();
+    SnapshotHeader header{};
+    if(bytes.size() < sizeof(header)) return nullopt;
+    memcpy(&header, bytes.data(), sizeof(header));
+    if(memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION
+       || header.byteOrder != BYTE_ORDER_MARK || header.source != stamp) return nullopt;
+
+    // the sections have to fill the rest of the file exactly
+    uint64_t rest = bytes.size() - sizeof(header);
+    if(header.words == 0 || header.words > rest / sizeof(uint64_t)) return nullopt;
+    rest -= header.words * sizeof(uint64_t);
+    if(header.keyIndex > rest / sizeof(uint32_t)) return nullopt;
+    rest -= header.keyIndex * sizeof(uint32_t);
+    if(header.strings != rest) return nullopt;
+
+    const char* words = bytes.data() + sizeof(header);
+    const char* keyIndex = words + header.words * sizeof(uint64_t);
+    const char* strings = keyIndex + header.keyIndex * sizeof(uint32_t);
+    TapeJSON tape({reinterpret_cast<const uint64_t*>(words), header.words},
+                  {strings, header.strings},
+                  {reinterpret_cast<const uint32_t*>(keyIndex), header.keyIndex},
+                  std::move(file));
+    // offsets in the words are followed without bounds checks, a corrupted body is parsed again instead
+    if(sectionsChecksum(tape) != header.checksum) return nullopt;
+    return tape;
+}
+
+TapeJSON snapshotTapeJSON(const string& filePath) {
+    const InputJSON input(filePath);
+    optional<SourceStamp> stamp = filePath == "-" ? nullopt : fileStamp(filePath);
+    if(!stamp) return parseTapeJSON(input.view());
+    stamp->hash = hashBytes(input.view());
+
+    const string path = snapshotPath(filePath);
+    if(optional<TapeJSON> tape = loadSnapshot(path, *stamp)) return std::move(*tape);
+    TapeJSON tape = parseTapeJSON(input.view());
+    writeSnapshot(tape, *stamp, path); // only a cache, the tape is still good if it could not be written
+    return tape;
+}
@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "tape.h"
+
+// version of the snapshot layout, snapshots of other versions are ignored
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+/**
+ * Size, modification time and content hash of the JSON file a snapshot was written from.
+ * The size and time are compared first since they are free, the hash catches rewrites that keep both
+ */
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t modified = 0; // file time ticks
+    uint64_t hash = 0;
+
+    bool operator==(const SourceStamp&) const = default;
+};
+
+/**
+ *
+ * @param bytes bytes to hash
+ * @return 64-bit hash of the bytes, read 32 bytes at a time
+ */
+uint64_t hashBytes(std::string_view bytes);
+
+/**
+ *
+ * @param filePath file path of the JSON file
+ * @return path of its snapshot, next to it
+ */
+std::string snapshotPath(const std::string& filePath);
+
+/**
+ * Writes the tape to a binary snapshot file: a header with the stamp of the source and a checksum followed by
+ * the words, the key index and the strings. Everything is addressed by offsets so the file can be
+ * mapped anywhere. The file is written under a temporary name and renamed so readers never see half of it
+ *
+ * @param tape parsed tape of the JSON file
+ * @param stamp stamp of the JSON file the tape was parsed from
+ * @param path path of the snapshot file
+ * @return false if the snapshot could not be written
+ */
+bool writeSnapshot(const TapeJSON& tape, const SourceStamp& stamp, const std::string& path);
+
+/**
+ * Maps a snapshot, the returned tape reads the mapped file directly. The tape trusts its words,
+ * so the checksum of the sections has to match before it is handed out
+ *
+ * @param path path of the snapshot file
+ * @param stamp stamp of the JSON file the snapshot should belong to
+ * @return the tape, empty if there is no snapshot or it is of another version, another source, truncated or corrupted
+ */
+std::optional<TapeJSON> loadSnapshot(const std::string& path, const SourceStamp& stamp);
+
+/**
+ * Tape of a JSON file from its snapshot if the snapshot is still valid, otherwise parses the file
+ * and writes a new snapshot next to it. Stdin is parsed without a snapshot.
+ * The JSON file is still read to check its hash but it is not parsed
+ *
+ * @param filePath file path of the JSON file
+ * @return tape of the JSON file
+ */
+TapeJSON snapshotTapeJSON(const std::string& filePath);
+
+#endif //SNAPSHOT_H
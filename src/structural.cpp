@@ -0,0 +1,224 @@
+#include "structural.h"
+
+#include <bit>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define STRUCTURAL_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+using Classifier = StructuralMasks (*)(const char* block);
+
+constexpr string_view::size_type BLOCK_SIZE = 64;
+
+StructuralMasks classifyBlockScalar(const char* block) {
+    StructuralMasks masks{};
+    for(size_t i = 0; i < BLOCK_SIZE; i++) {
+        const uint64_t bit = uint64_t{1} << i;
+        switch(block[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{':
+            case '[': masks.open |= bit; break;
+            case '}':
+            case ']': masks.close |= bit; break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r': masks.whitespace |= bit; break;
+            default: break;
+        }
+    }
+    return masks;
+}
+
+#ifdef STRUCTURAL_X86
+
+// '[' and ']' only differ from '{' and '}' by the 0x20 bit, so OR-ing it in lets one compare find both.
+// Whitespace is found with a table lookup on the low nibble: the table holds the whitespace character
+// with that nibble, or a byte with a different nibble. Bytes with the high bit set look up 0 and never match
+
+#define WHITESPACE_TABLE ' ', 0, 1, 1, 1, 1, 1, 1, 1, '\t', '\n', 1, 1, '\r', 1, 1
+
+__attribute__((target("avx2")))
+StructuralMasks classifyBlockAVX2(const char* block) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i fold = _mm256_set1_epi8(0x20);
+    const __m256i whitespace = _mm256_setr_epi8(WHITESPACE_TABLE, WHITESPACE_TABLE);
+    StructuralMasks masks{};
+    for(size_t shift = 0; shift < BLOCK_SIZE; shift += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + shift));
+        const __m256i folded = _mm256_or_si256(chunk, fold);
+        masks.quote |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)))} << shift;
+        masks.backslash |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)))} << shift;
+        masks.open |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, open)))} << shift;
+        masks.close |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, close)))} << shift;
+        const __m256i spaces = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(whitespace, chunk), chunk);
+        masks.whitespace |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(spaces))} << shift;
+    }
+    return masks;
+}
+
+__attribute__((target("sse4.2")))
+StructuralMasks classifyBlockSSE42(const char* block) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i whitespace = _mm_setr_epi8(WHITESPACE_TABLE);
+    StructuralMasks masks{};
+    for(size_t shift = 0; shift < BLOCK_SIZE; shift += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + shift));
+        const __m128i folded = _mm_or_si128(chunk, fold);
+        masks.quote |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))} << shift;
+        masks.backslash |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))} << shift;
+        masks.open |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, open)))} << shift;
+        masks.close |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, close)))} << shift;
+        const __m128i spaces = _mm_cmpeq_epi8(_mm_shuffle_epi8(whitespace, chunk), chunk);
+        masks.whitespace |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(spaces))} << shift;
+    }
+    return masks;
+}
+
+#undef WHITESPACE_TABLE
+
+#endif
+
+/**
+ * Picks the classifier for the instruction sets this CPU supports
+ *
+ * @return classifier and its name
+ */
+pair<Classifier, const char*> selectClassifier() {
+#ifdef STRUCTURAL_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return {classifyBlockAVX2, "avx2"};
+    if(__builtin_cpu_supports("sse4.2")) return {classifyBlockSSE42, "sse4.2"};
+#endif
+    return {classifyBlockScalar, "scalar"};
+}
+
+inline const pair<Classifier, const char*>& activeClassifier() {
+    static const pair<Classifier, const char*> classifier = selectClassifier();
+    return classifier;
+}
+
+StructuralMasks classifyBlock(const char* block) {
+    return activeClassifier().first(block);
+}
+
+const char* structuralInstructionSet() {
+    return activeClassifier().second;
+}
+
+/**
+ * Classifies the block starting at pos, the last block of the input is padded with spaces
+ *
+ * @param classify classifier to use
+ * @param json JSON string
+ * @param pos start of the block
+ * @return masks of the block
+ */
+inline StructuralMasks classifyAt(const Classifier classify, const string_view json, const string_view::size_type pos) {
+    if(json.size() - pos >= BLOCK_SIZE) return classify(json.data() + pos);
+    char padded[BLOCK_SIZE];
+    memset(padded, ' ', BLOCK_SIZE);
+    memcpy(padded, json.data() + pos, json.size() - pos);
+    return classify(padded);
+}
+
+/**
+ * Marks the characters escaped by a backslash. Every odd backslash of a run escapes the next character
+ *
+ * @param backslash backslash mask of the block
+ * @param carry 1 if the last character of the previous block escapes the first one of this block, updated for the next block
+ * @return mask of escaped characters
+ */
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& carry) {
+    constexpr uint64_t evenBits = 0x5555555555555555ULL;
+    backslash &= ~carry; // an escaped backslash does not escape anything
+    const uint64_t followsEscape = backslash << 1 | carry;
+    // runs of backslashes starting on an odd bit, adding them carries the run one past its end
+    const uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+    const uint64_t evenSequences = oddStarts + backslash;
+    carry = evenSequences < oddStarts ? 1 : 0;
+    const uint64_t invert = evenSequences << 1;
+    return (evenBits ^ invert) & followsEscape;
+}
+
+/**
+ *
+ * @param x bitmask
+ * @return bit i is the XOR of bits 0 to i of x
+ */
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+string_view::size_type findStringEnd(const string_view json, const string_view::size_type pos) {
+    const Classifier classify = activeClassifier().first;
+    uint64_t carry = 0;
+    for(string_view::size_type block = pos; block < json.size(); block += BLOCK_SIZE) {
+        const StructuralMasks masks = classifyAt(classify, json, block);
+        if(const uint64_t quotes = masks.quote & ~findEscaped(masks.backslash, carry))
+            return block + countr_zero(quotes);
+    }
+    return string_view::npos;
+}
+
+string_view::size_type findQuoteOrBackslash(const string_view json, const string_view::size_type pos) {
+    const Classifier classify = activeClassifier().first;
+    for(string_view::size_type block = pos; block < json.size(); block += BLOCK_SIZE) {
+        const StructuralMasks masks = classifyAt(classify, json, block);
+        if(const uint64_t special = masks.quote | masks.backslash) return block + countr_zero(special);
+    }
+    return string_view::npos;
+}
+
+string_view::size_type findNonWhitespace(const string_view json, const string_view::size_type pos) {
+    const Classifier classify = activeClassifier().first;
+    for(string_view::size_type block = pos; block < json.size(); block += BLOCK_SIZE) {
+        // the padding of the last block is whitespace, so a hit is always inside json
+        if(const uint64_t other = ~classifyAt(classify, json, block).whitespace) return block + countr_zero(other);
+    }
+    return json.size();
+}
+
+string_view::size_type findContainerEnd(const string_view json, const string_view::size_type pos) {
+    const Classifier classify = activeClassifier().first;
+    uint64_t carry = 0;
+    uint64_t inString = 0; // all ones if the previous block ended inside a string
+    long long depth = 1;
+    for(string_view::size_type block = pos; block < json.size(); block += BLOCK_SIZE) {
+        const StructuralMasks masks = classifyAt(classify, json, block);
+        const uint64_t quotes = masks.quote & ~findEscaped(masks.backslash, carry);
+        const uint64_t strings = prefixXor(quotes) ^ inString;
+        inString = static_cast<uint64_t>(static_cast<int64_t>(strings) >> 63);
+        const uint64_t open = masks.open & ~strings;
+        const uint64_t close = masks.close & ~strings;
+        // the container can only end in this block if there are enough closing brackets
+        if(popcount(close) < depth) {
+            depth += popcount(open) - popcount(close);
+            continue;
+        }
+        for(uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+            const int bit = countr_zero(brackets);
+            if(open >> bit & 1) depth++;
+            else if(--depth == 0) return block + bit;
+        }
+    }
+    return string_view::npos;
+}
@@ -0,0 +1,76 @@
+#ifndef STRUCTURAL_H
+#define STRUCTURAL_H
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Characters of one 64-byte block of JSON text as bitmasks,
+ * bit i is set if byte i of the block is that character
+ */
+struct StructuralMasks {
+    uint64_t quote;     // "
+    uint64_t backslash; // '\'
+    uint64_t open;      // { and [
+    uint64_t close;     // } and ]
+    uint64_t whitespace; // space, \t, \n and \r
+};
+
+/**
+ * Classifies 64 bytes with the fastest instruction set of this CPU (AVX2, SSE4.2 or scalar)
+ *
+ * @param block pointer to 64 readable bytes
+ * @return masks of the block
+ */
+StructuralMasks classifyBlock(const char* block);
+
+/**
+ * Portable reference implementation of classifyBlock
+ *
+ * @param block pointer to 64 readable bytes
+ * @return masks of the block
+ */
+StructuralMasks classifyBlockScalar(const char* block);
+
+/**
+ *
+ * @return name of the instruction set classifyBlock dispatches to
+ */
+const char* structuralInstructionSet();
+
+/**
+ * Finds the closing quotation mark of a string, escaped quotation marks are skipped
+ *
+ * @param json JSON string
+ * @param pos position right after the opening quotation mark
+ * @return position of the closing quotation mark, npos if there is none
+ */
+std::string_view::size_type findStringEnd(std::string_view json, std::string_view::size_type pos);
+
+/**
+ * Finds the next quotation mark or backslash, where a string either ends or has an escape sequence
+ *
+ * @param json JSON string
+ * @param pos position to start searching from
+ * @return position of the quotation mark or backslash, npos if there is none
+ */
+std::string_view::size_type findQuoteOrBackslash(std::string_view json, std::string_view::size_type pos);
+
+/**
+ * Skips a run of whitespace, used for the long indentation runs of pretty-printed JSON
+ *
+ * @param json JSON string
+ * @param pos position to start skipping from
+ * @return position of the first character that isn't whitespace, size of json if there is none
+ */
+std::string_view::size_type findNonWhitespace(std::string_view json, std::string_view::size_type pos);
+
+/**
+ * Finds the bracket closing an object or array, brackets inside strings are ignored
+ *
+ * @param json JSON string
+ * @param pos position right after the opening bracket
+ * @return position of the matching closing bracket, npos if there is none
+ */
+std::string_view::size_type findContainerEnd(std::string_view json, std::string_view::size_type pos);
+
+#endif //STRUCTURAL_H
@@ -0,0 +1,129 @@
+#include "tape.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using namespace std;
+
+TapeJSON TapeBuffers::view() const {
+    return {words, strings, keyIndex};
+}
+
+TapeJSON::TapeJSON(TapeBuffers&& buffers) {
+    auto owned = make_shared<const TapeBuffers>(std::move(buffers));
+    words = owned->words;
+    strings = owned->strings;
+    keyIndex = owned->keyIndex;
+    storage = std::move(owned);
+}
+
+string_view TapeJSON::stringAt(const size_t offset) const {
+    uint32_t length;
+    memcpy(&length, strings.data() + offset, sizeof(length));
+    return {strings.data() + offset + sizeof(length), length};
+}
+
+TypeJSON TapeRef::type() const {
+    switch(tape->tag(wordIndex)) {
+        case TAPE_OBJECT: return OBJECT;
+        case TAPE_ARRAY: return ARRAY;
+        case TAPE_STRING: return STRING;
+        case TAPE_INT: return INT;
+        case TAPE_FLOAT: return FLOAT;
+        case TAPE_TRUE:
+        case TAPE_FALSE: return BOOL;
+        default: return typeNULL;
+    }
+}
+
+string_view TapeRef::asString() const {
+    return tape->stringAt(tape->payload(wordIndex));
+}
+
+long long TapeRef::asInt() const {
+    return static_cast<long long>(tape->words[wordIndex + 1]);
+}
+
+double TapeRef::asDouble() const {
+    return bit_cast<double>(tape->words[wordIndex + 1]);
+}
+
+bool TapeRef::asBool() const {
+    return tape->tag(wordIndex) == TAPE_TRUE;
+}
+
+size_t TapeRef::size() const {
+    if(const uint64_t count = tape->payload(wordIndex) >> 32; count < TapeJSON::COUNT_SATURATED) return count;
+    size_t count = 0;
+    const size_t end = tape->containerEnd(wordIndex);
+    for(TapeRef child(*tape, wordIndex + 1); child.wordIndex < end; child = child.next()) count++;
+    return type() == OBJECT ? count / 2 : count;
+}
+
+optional<TapeRef> TapeRef::member(const string_view key) const {
+    const size_t end = tape->containerEnd(wordIndex);
+    if(const uint64_t indexed = tape->payload(end) >> 32; indexed != 0) {
+        const auto first = tape->keyIndex.begin() + static_cast<ptrdiff_t>(indexed - 1);
+        const auto last = first + static_cast<ptrdiff_t>(tape->payload(wordIndex) >> 32);
+        const auto found = lower_bound(first, last, key, [this](const uint32_t keyWord, const string_view k) {
+            return tape->stringAt(tape->payload(keyWord)) < k;
+        });
+        if(found == last || tape->stringAt(tape->payload(*found)) != key) return nullopt;
+        return TapeRef(*tape, *found + 1);
+    }
+    for(size_t i = wordIndex + 1; i < end;) {
+        const TapeRef value(*tape, i + 1);
+        if(tape->stringAt(tape->payload(i)) == key) return value;
+        i = value.next().wordIndex;
+    }
+    return nullopt;
+}
+
+optional<TapeRef> TapeRef::item(const size_t position) const {
+    const size_t end = tape->containerEnd(wordIndex);
+    TapeRef child(*tape, wordIndex + 1);
+    for(size_t i = 0; i < position && child.wordIndex < end; i++) child = child.next();
+    if(child.wordIndex >= end) return nullopt;
+    return child;
+}
+
+TapeRef TapeRef::next() const {
+    switch(tape->tag(wordIndex)) {
+        case TAPE_OBJECT:
+        case TAPE_ARRAY: return {*tape, tape->containerEnd(wordIndex) + 1};
+        case TAPE_INT:
+        case TAPE_FLOAT: return {*tape, wordIndex + 2};
+        default: return {*tape, wordIndex + 1};
+    }
+}
+
+ValueJSON TapeRef::toValue() const { // NOLINT(*-no-recursion)
+    switch(type()) {
+        case STRING: return ValueJSON(asString());
+        case INT: return ValueJSON(asInt());
+        case FLOAT: return ValueJSON(asDouble());
+        case BOOL: return ValueJSON(asBool());
+        case OBJECT: {
+            ObjectJSON object;
+            object.reserve(size());
+            const size_t end = tape->containerEnd(wordIndex);
+            for(size_t i = wordIndex + 1; i < end;) {
+                const TapeRef value(*tape, i + 1);
+                object.try_emplace(KeyJSON(tape->stringAt(tape->payload(i))), value.toValue());
+                i = value.next().wordIndex;
+            }
+            return ValueJSON(std::move(object));
+        }
+        case ARRAY: {
+            ArrayJSON array;
+            const size_t end = tape->containerEnd(wordIndex);
+            for(TapeRef item(*tape, wordIndex + 1); item.wordIndex < end; item = item.next()) {
+                array.push_back(item.toValue());
+            }
+            return ValueJSON(std::move(array));
+        }
+        case typeNULL: break;
+    }
+    return {};
+}
@@ -0,0 +1,212 @@
+#ifndef TAPE_H
+#define TAPE_H
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "value.h"
+
+/**
+ * Type of a tape word, stored in its top byte
+ */
+enum TapeTag : uint8_t {
+    TAPE_OBJECT = '{',     // payload: index of the matching end word | member count << 32
+    TAPE_OBJECT_END = '}', // payload: index of the matching start word | key index offset + 1 << 32 if indexed
+    TAPE_ARRAY = '[',
+    TAPE_ARRAY_END = ']',  // payload: index of the matching start word
+    TAPE_STRING = '"',     // payload: offset of the string in the string buffer
+    TAPE_INT = 'l',        // the next word is the value
+    TAPE_FLOAT = 'd',      // the next word holds the bits of the value
+    TAPE_TRUE = 't',
+    TAPE_FALSE = 'f',
+    TAPE_NULL = 'n'
+};
+
+struct TapeJSON;
+
+/**
+ * Growing buffers of a tape while it is parsed, see TapeJSON for their layout
+ */
+struct TapeBuffers {
+    std::vector<uint64_t> words;
+    std::string strings;
+    std::vector<uint32_t> keyIndex;
+
+    /**
+     *
+     * @return tape reading the buffers, valid until they change
+     */
+    [[nodiscard]] TapeJSON view() const;
+};
+
+/**
+ * JSON document flattened into one contiguous tape of tagged 64-bit words in document order.
+ * Objects are their keys and values one after another, every container records where it ends
+ * so it can be skipped in O(1). Strings live in a separate buffer, each prefixed by its 32-bit length.
+ * Wide objects also get their keys sorted in the key index so a member is found by binary search.
+ * The tape only reads its words, strings and key index, they are either the buffers it was parsed into
+ * or a mapped snapshot, kept alive by the storage shared between copies
+ */
+struct TapeJSON {
+    static constexpr int TAG_SHIFT = 56;
+    static constexpr uint64_t PAYLOAD_MASK = (uint64_t{1} << TAG_SHIFT) - 1;
+    static constexpr uint64_t INDEX_MASK = 0xFFFFFFFF; // container words hold 32-bit indices
+    static constexpr uint64_t COUNT_SATURATED = 0xFFFFFF; // containers this big are counted by walking them
+    static constexpr uint64_t INDEXED_MEMBERS = 32; // objects with this many members get a key index
+
+    std::span<const uint64_t> words;
+    std::string_view strings;
+    std::span<const uint32_t> keyIndex; // word indices of the keys of each indexed object, sorted by key
+    std::shared_ptr<const void> storage; // owner of the memory of the spans, empty if they are borrowed
+
+    /**
+     *
+     * @param buffers parsed buffers, the tape takes them over
+     */
+    explicit TapeJSON(TapeBuffers&& buffers);
+
+    /**
+     *
+     * @param words words of the tape
+     * @param strings string buffer
+     * @param keyIndex key index
+     * @param storage keeps the memory of the words, strings and key index alive, empty to borrow them
+     */
+    TapeJSON(const std::span<const uint64_t> words, const std::string_view strings,
+             const std::span<const uint32_t> keyIndex, std::shared_ptr<const void> storage = nullptr)
+        : words(words), strings(strings), keyIndex(keyIndex), storage(std::move(storage)) {}
+
+    /**
+     *
+     * @param tag type of the word
+     * @param payload low 56 bits of the word
+     * @return the tape word
+     */
+    static uint64_t word(const TapeTag tag, const uint64_t payload) {
+        return static_cast<uint64_t>(tag) << TAG_SHIFT | payload;
+    }
+
+    /**
+     *
+     * @param index index of a word
+     * @return type of the word
+     */
+    [[nodiscard]] TapeTag tag(const std::size_t index) const {
+        return static_cast<TapeTag>(words[index] >> TAG_SHIFT);
+    }
+
+    /**
+     *
+     * @param index index of a word
+     * @return low 56 bits of the word
+     */
+    [[nodiscard]] uint64_t payload(const std::size_t index) const {
+        return words[index] & PAYLOAD_MASK;
+    }
+
+    /**
+     *
+     * @param index index of an object or array start word
+     * @return index of its end word
+     */
+    [[nodiscard]] std::size_t containerEnd(const std::size_t index) const {
+        return payload(index) & INDEX_MASK;
+    }
+
+    /**
+     *
+     * @param offset offset of the string in the string buffer
+     * @return the string
+     */
+    [[nodiscard]] std::string_view stringAt(std::size_t offset) const;
+
+    /**
+     *
+     * @return bytes taken by the words, the strings and the key index
+     */
+    [[nodiscard]] std::size_t memoryUsage() const {
+        return words.size_bytes() + strings.size() + keyIndex.size_bytes();
+    }
+};
+
+/**
+ * Value on a tape, cheap to copy. Valid as long as the tape is alive and unchanged
+ */
+class TapeRef {
+    const TapeJSON* tape;
+    std::size_t wordIndex;
+
+public:
+    /**
+     *
+     * @param tape tape of the value
+     * @param index index of the first word of the value
+     */
+    TapeRef(const TapeJSON& tape, const std::size_t index)
+        : tape(&tape), wordIndex(index) {}
+
+    /**
+     *
+     * @param tape tape of a whole document
+     * @return the top-level object
+     */
+    static TapeRef root(const TapeJSON& tape) {
+        return {tape, 0};
+    }
+
+    /**
+     *
+     * @return index of the first word of the value
+     */
+    [[nodiscard]] std::size_t index() const {
+        return wordIndex;
+    }
+
+    [[nodiscard]] TypeJSON type() const;
+
+    [[nodiscard]] std::string_view asString() const;
+    [[nodiscard]] long long asInt() const;
+    [[nodiscard]] double asDouble() const;
+    [[nodiscard]] bool asBool() const;
+
+    /**
+     *
+     * @return number of members of an object or items of an array
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Looks up a member of an object by binary search if the object is indexed,
+     * otherwise by walking the members and skipping their values in O(1)
+     *
+     * @param key key of the member
+     * @return value of the member, empty if there is no such key
+     */
+    [[nodiscard]] std::optional<TapeRef> member(std::string_view key) const;
+
+    /**
+     *
+     * @param position position of the item in an array
+     * @return the item, empty if position is out of bounds
+     */
+    [[nodiscard]] std::optional<TapeRef> item(std::size_t position) const;
+
+    /**
+     *
+     * @return value after this one on the tape
+     */
+    [[nodiscard]] TapeRef next() const;
+
+    /**
+     * Materializes the value, strings, objects and arrays are copied from the tape
+     *
+     * @return the value as a tree
+     */
+    [[nodiscard]] ValueJSON toValue() const;
+};
+
+#endif //TAPE_H
@@ -0,0 +1,74 @@
+#include "threadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(const unsigned threads) {
+    const unsigned count = max(threads, 1u);
+    for(unsigned i = 0; i < count; i++) {
+        queues.push_back(make_unique<Queue>());
+    }
+    for(unsigned i = 0; i < count; i++) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::push(function<void()> task) {
+    Queue& queue = *queues[next++ % queues.size()];
+    {
+        lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        lock_guard lock(sleepMutex);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+/**
+ * Runs one task, from the front of the preferred queue or stolen from the back of another one
+ *
+ * @param preferred index of the queue to look in first
+ * @return false if all queues were empty
+ */
+bool ThreadPool::runOne(const size_t preferred) {
+    for(size_t i = 0; i < queues.size(); i++) {
+        Queue& queue = *queues[(preferred + i) % queues.size()];
+        function<void()> task;
+        {
+            lock_guard lock(queue.mutex);
+            if(queue.tasks.empty()) continue;
+            if(i == 0) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            } else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+        }
+        pending--;
+        task();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::work(const size_t index) {
+    while(true) {
+        if(runOne(index)) continue;
+        unique_lock lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if(stopping) return;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing thread pool. Every worker has its own queue, tasks are handed out round robin
+ * and a worker with an empty queue steals from the back of the others
+ */
+class ThreadPool {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> next = 0;
+    std::atomic<long long> pending = 0; // queued tasks, briefly negative when a task is taken before it is counted
+    std::atomic<bool> stopping = false;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void push(std::function<void()> task);
+    bool runOne(std::size_t preferred);
+    void work(std::size_t index);
+
+public:
+    /**
+     *
+     * @param threads number of worker threads
+     */
+    explicit ThreadPool(unsigned threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     *
+     * @param task callable to run on a worker
+     * @return future with the result of the task
+     */
+    template<typename F>
+    auto submit(F task) -> std::future<decltype(task())> {
+        auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+        auto future = packaged->get_future();
+        push([packaged] { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * Waits for the future, the calling thread runs queued tasks in the meantime
+     *
+     * @param future future of a task of this pool
+     * @return result of the task
+     */
+    template<typename T>
+    T wait(std::future<T>& future) {
+        while(future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if(!runOne(0)) {
+                future.wait();
+                break;
+            }
+        }
+        return future.get();
+    }
+};
+
+#endif //THREADPOOL_H
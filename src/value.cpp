@@ -1,50 +1,305 @@
 #include "value.h"
 
-#include <format>
-#include <sstream>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <utility>
 
 using namespace std;
 
-string objectToString(const unordered_map<string, ValueJSON>& obj) { // NOLINT(*-no-recursion)
-    stringstream ss;
-    stringstream::pos_type pos;
-    ss << "{ ";
-    for (auto &[key, value] : obj) {
-        ss << '"' << key << "\": " << toString(value);
-        pos = ss.tellp();
-        ss << ", ";
+void KeyJSON::allocate(const string_view key, pmr::memory_resource* resource) {
+    if(key.size() >= INTERNED) throw length_error("Key too long");
+    auto* chars = static_cast<char*>(resource->allocate(key.size(), 1));
+    memcpy(chars, key.data(), key.size());
+    external = {chars, resource};
+}
+
+KeyJSON KeysJSON::intern(const string_view key) {
+    if(key.size() <= KeyJSON::INLINE_SIZE) return KeyJSON(key);
+    auto found = keys.find(key);
+    if(found == keys.end()) {
+        // the characters are left to the resource, keys handed out may outlive the dictionary
+        KeyJSON entry(key, resource());
+        entry.length |= KeyJSON::INTERNED;
+        found = keys.insert(std::move(entry)).first;
+    }
+    KeyJSON handle;
+    handle.length = found->length;
+    handle.keyHash = found->keyHash;
+    handle.external = found->external;
+    return handle;
+}
+
+void ValueJSON::allocateString(const string_view string, pmr::memory_resource* resource) {
+    if(string.size() > UINT32_MAX) throw length_error("String too long");
+    auto* block = static_cast<char*>(resource->allocate(sizeof(resource) + string.size(), alignof(pmr::memory_resource*)));
+    memcpy(block, &resource, sizeof(resource));
+    memcpy(block + sizeof(resource), string.data(), string.size());
+    const auto size = static_cast<uint32_t>(string.size());
+    memcpy(storage + SIZE_OFFSET, &size, sizeof(size));
+    stringSize = LONG_STRING;
+    setPayload(static_cast<const char*>(block + sizeof(resource)));
+}
+
+/**
+ * Moves a container into memory from its own memory resource
+ *
+ * @param container object or array
+ * @return the container out of line
+ */
+template<typename Container>
+Container* allocateContainer(Container&& container) {
+    pmr::memory_resource* resource = container.get_allocator().resource();
+    return new(resource->allocate(sizeof(Container), alignof(Container))) Container(std::move(container));
+}
+
+/**
+ * Destroys a container allocated by allocateContainer
+ *
+ * @param container object or array
+ */
+template<typename Container>
+void deallocateContainer(Container* container) noexcept {
+    pmr::memory_resource* resource = container->get_allocator().resource();
+    container->~Container();
+    resource->deallocate(container, sizeof(Container), alignof(Container));
+}
+
+ValueJSON::ValueJSON(ObjectJSON object)
+    : type(OBJECT) {
+    setPayload(allocateContainer(std::move(object)));
+}
+
+ValueJSON::ValueJSON(ArrayJSON array)
+    : type(ARRAY) {
+    setPayload(allocateContainer(std::move(array)));
+}
+
+ValueJSON::ValueJSON(const ValueJSON& other) // NOLINT(*-no-recursion)
+    : type(other.type), stringSize(other.stringSize) {
+    memcpy(storage, other.storage, INLINE_SIZE);
+    switch(type) {
+        case STRING:
+            // borrowed strings are copied too, the copy may outlive the JSON they point into
+            if(stringSize >= BORROWED_STRING) allocateString(other.asString(), pmr::get_default_resource());
+            break;
+        // copies of the containers allocate from the default resource
+        case OBJECT: setPayload(allocateContainer(ObjectJSON(other.asObject()))); break;
+        case ARRAY: setPayload(allocateContainer(ArrayJSON(other.asArray()))); break;
+        default: break;
+    }
+}
+
+void ValueJSON::destroy() noexcept { // NOLINT(*-no-recursion)
+    switch(type) {
+        case STRING: {
+            char* block = payload<char*>() - sizeof(pmr::memory_resource*);
+            pmr::memory_resource* resource;
+            memcpy(&resource, block, sizeof(resource));
+            resource->deallocate(block, sizeof(resource) + asString().size(), alignof(pmr::memory_resource*));
+            break;
+        }
+        case OBJECT: deallocateContainer(payload<ObjectJSON*>()); break;
+        case ARRAY: deallocateContainer(payload<ArrayJSON*>()); break;
+        default: break;
+    }
+}
+
+void ObjectJSON::rehash(const size_t slotCount) {
+    slots.assign(slotCount, 0);
+    const size_t mask = slotCount - 1;
+    for(size_t i = 0; i < members.size(); i++) {
+        size_t slot = members[i].first.hash() & mask;
+        while(slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+void ObjectJSON::reserve(const size_t capacity) {
+    members.reserve(capacity);
+    if(capacity > INDEXED_SIZE && slots.size() < 2 * capacity) rehash(bit_ceil(2 * capacity));
+}
+
+pair<ObjectJSON::iterator, bool> ObjectJSON::try_emplace(KeyJSON key, ValueJSON value) {
+    if(const size_t i = position(key); i != members.size()) return {members.begin() + static_cast<ptrdiff_t>(i), false};
+    if(members.size() >= UINT32_MAX) throw length_error("Object too big");
+    members.emplace_back(std::move(key), std::move(value));
+    // the table stays at most half full
+    if(members.size() > INDEXED_SIZE && slots.size() < 2 * members.size()) {
+        rehash(bit_ceil(2 * members.size()));
+    } else if(!slots.empty()) {
+        const size_t mask = slots.size() - 1;
+        size_t slot = members.back().first.hash() & mask;
+        while(slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = static_cast<uint32_t>(members.size());
     }
-    ss.seekp(pos);
-    ss << " }";
-    return ss.str();
+    return {members.end() - 1, true};
 }
 
-string arrayToString(const vector<ValueJSON>& array) { // NOLINT(*-no-recursion)
-    stringstream ss;
-    stringstream::pos_type pos;
-    ss << "[ ";
-    for (const ValueJSON& item : array) {
-        ss << toString(item);
-        pos = ss.tellp();
-        ss << ", ";
+ArrayJSON::ArrayJSON(const ArrayJSON& other, const allocator_type& allocator)
+    : items(visit([&](const auto& vector) {
+        using Vector = remove_cvref_t<decltype(vector)>;
+        return decltype(items)(in_place_type<Vector>, vector, allocator);
+    }, other.items)) {}
+
+ArrayJSON::ArrayJSON(ArrayJSON&& other, const allocator_type& allocator)
+    : items(visit([&](auto& vector) {
+        using Vector = remove_cvref_t<decltype(vector)>;
+        return decltype(items)(in_place_type<Vector>, std::move(vector), allocator);
+    }, other.items)) {}
+
+const ValueJSON& ArrayJSON::at(const size_t index) const {
+    const auto* values = get_if<0>(&items);
+    if(values == nullptr) throw logic_error("Array is a column of numbers, its items are not values");
+    return values->at(index);
+}
+
+ValueJSON ArrayJSON::item(const size_t index) const {
+    switch(items.index()) {
+        case 1: return ValueJSON(get<1>(items).at(index));
+        case 2: return ValueJSON(get<2>(items).at(index));
+        default: return get<0>(items).at(index);
+    }
+}
+
+void ArrayJSON::reserve(const size_t capacity) {
+    visit([capacity](auto& vector) { vector.reserve(capacity); }, items);
+}
+
+void ArrayJSON::push_back(ValueJSON value) {
+    if(auto* values = get_if<0>(&items)) {
+        if(!values->empty() || (value.type != INT && value.type != FLOAT)) {
+            values->push_back(std::move(value));
+            return;
+        }
+        // the first item is a number, the array starts as a column with the room reserved for the values
+        const allocator_type allocator = values->get_allocator();
+        const size_t capacity = values->capacity();
+        if(value.type == INT) items.emplace<1>(allocator).reserve(capacity);
+        else items.emplace<2>(allocator).reserve(capacity);
+    }
+    if(auto* integers = get_if<1>(&items); integers != nullptr && value.type == INT) {
+        integers->push_back(value.asInt());
+        return;
+    }
+    if(auto* floats = get_if<2>(&items); floats != nullptr && value.type == FLOAT) {
+        floats->push_back(value.asDouble());
+        return;
     }
-    ss.seekp(pos);
-    ss << " ]";
-    return ss.str();
+    // an item of another type, the numbers become values again
+    pmr::vector<ValueJSON> values(get_allocator());
+    values.reserve(size() + 1);
+    for(size_t i = 0; i < size(); i++) values.push_back(item(i));
+    values.push_back(std::move(value));
+    items = std::move(values);
 }
 
-string toString(const ValueJSON& value) { // NOLINT(*-no-recursion)
+// bytes of output buffered before they are written to the stream
+constexpr size_t OUTPUT_CHUNK = 1 << 16;
+
+/**
+ * Hands the buffer to the stream once it holds a chunk
+ *
+ * @param out buffer of serialized output
+ * @param stream stream the buffer is written to, nullptr keeps everything in the buffer
+ */
+inline void flushChunk(string& out, ostream* stream) {
+    if(stream == nullptr || out.size() < OUTPUT_CHUNK) return;
+    stream->write(out.data(), static_cast<streamsize>(out.size()));
+    out.clear();
+}
+
+/**
+ * Appends a number in its shortest form, floating point numbers round trip without trailing zeroes
+ *
+ * @param out buffer to append to
+ * @param number integer or floating point number
+ */
+template<typename T>
+void appendNumber(string& out, const T number) {
+    char digits[32];
+    const char* end = to_chars(digits, digits + sizeof(digits), number).ptr;
+    out.append(digits, end - digits);
+}
+
+/**
+ * Appends the JSON text of the value to one buffer, nested values are appended in place
+ *
+ * @param value value to serialize
+ * @param out buffer to append to
+ * @param stream stream the buffer is written to whenever it holds a chunk, nullptr keeps everything in the buffer
+ */
+void serialize(const ValueJSON& value, string& out, ostream* stream) { // NOLINT(*-no-recursion)
     switch(value.type) {
-        case typeNULL: return "null";
-        case STRING: return "\"" + get<string>(value.value) + "\"";
-        case INT: return to_string(get<long long>(value.value));
-        case FLOAT: return format("{}", get<double>(value.value)); // to_string does not remove trailing zeroes pre C++26
-        case OBJECT: return objectToString(get<unordered_map<string, ValueJSON>>(value.value));
-        case ARRAY: return arrayToString(get<vector<ValueJSON>>(value.value));
-        case BOOL: {
-            if(get<bool>(value.value)) return "true";
-            return "false";
+        case typeNULL: out += "null"; break;
+        case STRING:
+            out += '"';
+            out += value.asString();
+            out += '"';
+            break;
+        case INT: appendNumber(out, value.asInt()); break;
+        case FLOAT: appendNumber(out, value.asDouble()); break;
+        case BOOL: out += value.asBool() ? "true" : "false"; break;
+        case OBJECT: {
+            const ObjectJSON& object = value.asObject();
+            if(object.empty()) {
+                out += "{}";
+                break;
+            }
+            out += "{ ";
+            for(auto member = object.begin(); member != object.end(); ++member) {
+                if(member != object.begin()) out += ", ";
+                out += '"';
+                out += member->first.view();
+                out += "\": ";
+                serialize(member->second, out, stream);
+            }
+            out += " }";
+            break;
+        }
+        case ARRAY: {
+            const ArrayJSON& array = value.asArray();
+            if(array.empty()) {
+                out += "[]";
+                break;
+            }
+            out += "[ ";
+            // only one kind of items is there, the other loops are empty
+            for(const ValueJSON& item : array.values()) {
+                if(&item != array.values().data()) out += ", ";
+                serialize(item, out, stream);
+            }
+            for(const long long& integer : array.integers()) {
+                if(&integer != array.integers().data()) out += ", ";
+                appendNumber(out, integer);
+                flushChunk(out, stream);
+            }
+            for(const double& floating : array.floats()) {
+                if(&floating != array.floats().data()) out += ", ";
+                appendNumber(out, floating);
+                flushChunk(out, stream);
+            }
+            out += " ]";
+            break;
         }
     }
-    return "error";
-}
\ No newline at end of file
+    flushChunk(out, stream);
+}
+
+void appendJSON(string& out, const ValueJSON& value) {
+    serialize(value, out, nullptr);
+}
+
+void writeJSON(ostream& out, const ValueJSON& value) {
+    string buffer;
+    buffer.reserve(OUTPUT_CHUNK + OUTPUT_CHUNK / 2);
+    serialize(value, buffer, &out);
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+}
+
+string toString(const ValueJSON& value) {
+    string out;
+    appendJSON(out, value);
+    return out;
+}
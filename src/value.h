@@ -1,11 +1,19 @@
 #ifndef VALUE_H
 #define VALUE_H
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
-enum TypeJSON {
+enum TypeJSON : uint8_t {
     STRING,
     INT,
     FLOAT,
@@ -15,21 +23,678 @@ enum TypeJSON {
     typeNULL // NULL taken
 };
 
-struct ValueJSON {
-    TypeJSON type;
-    std::variant<std::string, long long, double, bool,
-    std::unordered_map<std::string, ValueJSON>, std::vector<ValueJSON>> value;
+struct ValueJSON;
 
-    ValueJSON(const TypeJSON type,
-              const std::variant<std::string, long long, double, bool,
-              std::unordered_map<std::string, ValueJSON>, std::vector<ValueJSON>> &value)
-        : type(type),
-          value(value) {
+/**
+ * Object key with its hash computed once. Keys of up to 24 characters are stored inline,
+ * longer ones either own their characters or share them through the KeysJSON of their document,
+ * keys interned in the same dictionary are equal only if they point to the same characters.
+ * Allocator aware like the containers holding it: a long key copied into a container on another
+ * memory resource gets its own characters
+ */
+class KeyJSON {
+public:
+    static constexpr uint32_t INLINE_SIZE = 24;
+
+private:
+    static constexpr uint32_t INTERNED = uint32_t{1} << 31; // flag in length
+
+    uint32_t length = 0;
+    uint32_t keyHash = 0;
+    union {
+        char small[INLINE_SIZE]{};
+        struct {
+            const char* chars;
+            std::pmr::memory_resource* resource; // where the characters live
+        } external;
+    };
+
+    friend class KeysJSON;
+
+    [[nodiscard]] uint32_t size() const {
+        return length & ~INTERNED;
+    }
+
+    [[nodiscard]] bool isInline() const {
+        return length <= INLINE_SIZE;
+    }
+
+    [[nodiscard]] bool interned() const {
+        return (length & INTERNED) != 0;
+    }
+
+    /**
+     * Copies the characters of a long key to the memory resource
+     *
+     * @param key characters of the key
+     * @param resource memory resource of the characters
+     */
+    void allocate(std::string_view key, std::pmr::memory_resource* resource);
+
+    /**
+     * Copies the characters inline if they fit, to the memory resource otherwise
+     *
+     * @param key characters of the key
+     * @param hash hash of the key
+     * @param resource memory resource of long keys
+     */
+    void assign(const std::string_view key, const uint32_t hash, std::pmr::memory_resource* resource) {
+        length = static_cast<uint32_t>(key.size());
+        keyHash = hash;
+        if(key.size() <= INLINE_SIZE) std::memcpy(small, key.data(), key.size());
+        else allocate(key, resource);
+    }
+
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    /**
+     *
+     * @param key characters of the key
+     * @return hash of the key, the same for every string type
+     */
+    static uint32_t hashKey(std::string_view key) {
+        return static_cast<uint32_t>(std::hash<std::string_view>{}(key));
+    }
+
+    /**
+     * Copies the characters
+     *
+     * @param key characters of the key
+     * @param allocator allocator of the characters if they do not fit inline
+     */
+    KeyJSON(const std::string_view key, const allocator_type& allocator = {}) { // NOLINT(*-explicit-constructor)
+        assign(key, hashKey(key), allocator.resource());
+    }
+
+    KeyJSON(const char* key) // NOLINT(*-explicit-constructor)
+        : KeyJSON(std::string_view(key)) {}
+
+    KeyJSON() = default;
+
+    KeyJSON(const KeyJSON& other, const allocator_type& allocator = {}) {
+        if(other.interned() && other.external.resource == allocator.resource()) {
+            length = other.length;
+            keyHash = other.keyHash;
+            external = other.external;
+        } else {
+            assign(other.view(), other.keyHash, allocator.resource());
+        }
+    }
+
+    KeyJSON(KeyJSON&& other) noexcept
+        : length(std::exchange(other.length, 0)), keyHash(other.keyHash) {
+        std::memcpy(small, other.small, INLINE_SIZE); // the characters or the pointers, both trivially copyable
+    }
+
+    KeyJSON(KeyJSON&& other, const allocator_type& allocator) {
+        if(other.isInline() || other.external.resource == allocator.resource()) {
+            keyHash = other.keyHash;
+            length = std::exchange(other.length, 0);
+            std::memcpy(small, other.small, INLINE_SIZE);
+        } else {
+            assign(other.view(), other.keyHash, allocator.resource());
+        }
+    }
+
+    KeyJSON& operator=(KeyJSON&& other) noexcept {
+        if(this != &other) {
+            this->~KeyJSON();
+            new(this) KeyJSON(std::move(other));
+        }
+        return *this;
+    }
+
+    KeyJSON& operator=(const KeyJSON&) = delete;
+
+    ~KeyJSON() {
+        if(!isInline() && !interned()) external.resource->deallocate(const_cast<char*>(external.chars), length, 1);
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {isInline() ? small : external.chars, size()};
+    }
+
+    operator std::string_view() const { // NOLINT(*-explicit-constructor)
+        return view();
+    }
+
+    [[nodiscard]] uint32_t hash() const {
+        return keyHash;
+    }
+
+    /**
+     * Inline keys are compared as three words, interned keys by address,
+     * other keys by their characters when the hashes match
+     */
+    friend bool operator==(const KeyJSON& a, const KeyJSON& b) {
+        if(a.size() != b.size() || a.keyHash != b.keyHash) return false;
+        if(a.isInline()) {
+            uint64_t wordsA[3], wordsB[3];
+            std::memcpy(wordsA, a.small, sizeof(wordsA));
+            std::memcpy(wordsB, b.small, sizeof(wordsB));
+            return wordsA[0] == wordsB[0] && wordsA[1] == wordsB[1] && wordsA[2] == wordsB[2];
+        }
+        return a.external.chars == b.external.chars || a.view() == b.view();
+    }
+};
+
+/**
+ * Hashes object keys, keys of any string type hash the same so they can be looked up with string views
+ */
+struct KeyHash {
+    using is_transparent = void;
+
+    size_t operator()(const KeyJSON& key) const {
+        return key.hash();
+    }
+
+    template<typename K>
+    size_t operator()(const K& key) const {
+        return KeyJSON::hashKey(std::string_view(key));
+    }
+};
+
+/**
+ * Compares object keys, any string type is compared as a string view
+ */
+struct KeyEqual {
+    using is_transparent = void;
+
+    bool operator()(const KeyJSON& a, const KeyJSON& b) const {
+        return a == b;
+    }
+
+    template<typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+        return std::string_view(a) == std::string_view(b);
+    }
+};
+
+/**
+ * Dictionary of the keys of one document, each distinct key is stored once. The characters are allocated
+ * from the memory resource of the dictionary and never freed by it, so the interned keys stay valid
+ * as long as the resource, meant for the monotonic arenas of documents
+ */
+class KeysJSON {
+    std::pmr::unordered_set<KeyJSON, KeyHash, KeyEqual> keys;
+
+public:
+    explicit KeysJSON(std::pmr::memory_resource* resource)
+        : keys(resource) {}
+
+    /**
+     *
+     * @return memory resource of the characters
+     */
+    [[nodiscard]] std::pmr::memory_resource* resource() const {
+        return keys.get_allocator().resource();
+    }
+
+    /**
+     *
+     * @param key characters of the key
+     * @return the key interned in this dictionary, added if it is new
+     */
+    KeyJSON intern(std::string_view key);
+};
+
+// values allocate from the memory resource they were parsed with, copies allocate from the default resource
+class ObjectJSON;
+class ArrayJSON;
+
+/**
+ * JSON value in 16 bytes: its type, then either a string of up to 14 characters inline or 8 bytes of payload,
+ * a number, a boolean or a pointer to a longer string, an object or an array.
+ * What does not fit is allocated from the memory resource the value was made with and given back to it,
+ * copies allocate from the default resource like the containers do.
+ * A longer string can also be borrowed, a view into the JSON text it was parsed from, see borrow
+ */
+struct alignas(8) ValueJSON {
+    static constexpr uint8_t INLINE_SIZE = 14;
+
+    TypeJSON type = typeNULL; // changed only together with the payload
+
+private:
+    static constexpr uint8_t LONG_STRING = UINT8_MAX;         // string size of strings that are out of line
+    static constexpr uint8_t BORROWED_STRING = UINT8_MAX - 1; // and of strings that are views into the JSON
+    static constexpr std::size_t SIZE_OFFSET = 2;     // offsets in storage of the size of a long string
+    static constexpr std::size_t PAYLOAD_OFFSET = 6;  // and of the payload, 8 bytes into the value
+
+    uint8_t stringSize = 0; // size of an inline string, LONG_STRING or BORROWED_STRING
+    char storage[INLINE_SIZE]{};
+
+    template<typename T>
+    [[nodiscard]] T payload() const {
+        T value;
+        std::memcpy(&value, storage + PAYLOAD_OFFSET, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void setPayload(const T value) {
+        std::memcpy(storage + PAYLOAD_OFFSET, &value, sizeof(T));
+    }
+
+    /**
+     * Copies a string that does not fit inline into a block prefixed by the resource it comes from
+     *
+     * @param string characters of the string
+     * @param resource memory resource the block is allocated from
+     */
+    void allocateString(std::string_view string, std::pmr::memory_resource* resource);
+
+    /**
+     *
+     * @return true if part of the value is allocated out of line
+     */
+    [[nodiscard]] bool allocated() const {
+        return type == OBJECT || type == ARRAY || (type == STRING && stringSize == LONG_STRING);
     }
 
+    /**
+     * Gives back what the value allocated
+     */
+    void destroy() noexcept;
+
+public:
     ValueJSON() = default;
+
+    explicit ValueJSON(const long long integer)
+        : type(INT) {
+        setPayload(integer);
+    }
+
+    explicit ValueJSON(const double floating)
+        : type(FLOAT) {
+        setPayload(floating);
+    }
+
+    explicit ValueJSON(const bool boolean)
+        : type(BOOL) {
+        setPayload(boolean);
+    }
+
+    /**
+     *
+     * @param string characters of the string
+     * @param resource memory resource a string that does not fit inline is allocated from
+     */
+    explicit ValueJSON(const std::string_view string, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : type(STRING) {
+        if(string.size() > INLINE_SIZE) {
+            allocateString(string, resource);
+            return;
+        }
+        stringSize = static_cast<uint8_t>(string.size());
+        std::memcpy(storage, string.data(), string.size());
+    }
+
+    // would be taken for a bool otherwise
+    explicit ValueJSON(const char* string)
+        : ValueJSON(std::string_view(string)) {}
+
+    /**
+     * String value that refers to the characters instead of copying them if they do not fit inline.
+     * Nothing is allocated or given back, copies of the value own their characters again
+     *
+     * @param string characters of the string, have to outlive the value
+     * @return the string value
+     */
+    static ValueJSON borrow(const std::string_view string) {
+        if(string.size() <= INLINE_SIZE) return ValueJSON(string);
+        if(string.size() > UINT32_MAX) throw std::length_error("String too long");
+        ValueJSON value;
+        value.type = STRING;
+        value.stringSize = BORROWED_STRING;
+        const auto size = static_cast<uint32_t>(string.size());
+        std::memcpy(value.storage + SIZE_OFFSET, &size, sizeof(size));
+        value.setPayload(string.data());
+        return value;
+    }
+
+    /**
+     *
+     * @param object the object, moved next to its members into the memory resource it allocates from
+     */
+    explicit ValueJSON(ObjectJSON object);
+
+    /**
+     *
+     * @param array the array, moved next to its items into the memory resource it allocates from
+     */
+    explicit ValueJSON(ArrayJSON array);
+
+    ValueJSON(const ValueJSON& other);
+
+    ValueJSON(ValueJSON&& other) noexcept
+        : type(std::exchange(other.type, typeNULL)), stringSize(other.stringSize) {
+        std::memcpy(storage, other.storage, INLINE_SIZE);
+    }
+
+    ValueJSON& operator=(const ValueJSON& other) {
+        if(this != &other) *this = ValueJSON(other);
+        return *this;
+    }
+
+    ValueJSON& operator=(ValueJSON&& other) noexcept {
+        if(this == &other) return *this;
+        if(allocated()) destroy();
+        type = std::exchange(other.type, typeNULL);
+        stringSize = other.stringSize;
+        std::memcpy(storage, other.storage, INLINE_SIZE);
+        return *this;
+    }
+
+    ~ValueJSON() {
+        if(allocated()) destroy();
+    }
+
+    [[nodiscard]] long long asInt() const {
+        return payload<long long>();
+    }
+
+    [[nodiscard]] double asDouble() const {
+        return payload<double>();
+    }
+
+    [[nodiscard]] bool asBool() const {
+        return payload<bool>();
+    }
+
+    [[nodiscard]] std::string_view asString() const {
+        if(stringSize < BORROWED_STRING) return {storage, stringSize};
+        uint32_t size;
+        std::memcpy(&size, storage + SIZE_OFFSET, sizeof(size));
+        return {payload<const char*>(), size};
+    }
+
+    [[nodiscard]] const ObjectJSON& asObject() const {
+        return *payload<const ObjectJSON*>();
+    }
+
+    [[nodiscard]] ObjectJSON& asObject() {
+        return *payload<ObjectJSON*>();
+    }
+
+    [[nodiscard]] const ArrayJSON& asArray() const {
+        return *payload<const ArrayJSON*>();
+    }
+
+    [[nodiscard]] ArrayJSON& asArray() {
+        return *payload<ArrayJSON*>();
+    }
 };
 
+static_assert(sizeof(ValueJSON) == 16);
+
+/**
+ * JSON object as a flat vector of its members in insertion order, which is the order of the JSON.
+ * Small objects are searched linearly by the cached hashes of their keys, objects with more than
+ * INDEXED_SIZE members also get an open addressing table of member positions.
+ * Like a vector, inserting invalidates iterators and references to the members
+ */
+class ObjectJSON {
+public:
+    using value_type = std::pair<KeyJSON, ValueJSON>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using iterator = std::pmr::vector<value_type>::iterator;
+    using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+    static constexpr std::size_t INDEXED_SIZE = 16;
+
+private:
+    std::pmr::vector<value_type> members;
+    std::pmr::vector<uint32_t> slots; // member position + 1 by key hash, 0 if free. Empty up to INDEXED_SIZE
+
+    /**
+     *
+     * @param key key of any string type
+     * @return position of the member with the key, size() if there is none
+     */
+    template<typename K>
+    [[nodiscard]] std::size_t position(const K& key) const {
+        const auto hash = static_cast<uint32_t>(KeyHash{}(key));
+        const auto matches = [&](const std::size_t i) {
+            return members[i].first.hash() == hash && KeyEqual{}(members[i].first, key);
+        };
+        if(slots.empty()) {
+            for(std::size_t i = 0; i < members.size(); i++) {
+                if(matches(i)) return i;
+            }
+            return members.size();
+        }
+        const std::size_t mask = slots.size() - 1;
+        for(std::size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            if(matches(slots[slot] - 1)) return slots[slot] - 1;
+        }
+        return members.size();
+    }
+
+    /**
+     * Rebuilds the table of member positions
+     *
+     * @param slotCount number of slots, a power of two larger than the number of members
+     */
+    void rehash(std::size_t slotCount);
+
+public:
+    ObjectJSON() = default;
+
+    explicit ObjectJSON(const allocator_type& allocator)
+        : members(allocator), slots(allocator) {}
+
+    ObjectJSON(const ObjectJSON& other) = default;
+    ObjectJSON(ObjectJSON&& other) noexcept = default;
+
+    ObjectJSON(const ObjectJSON& other, const allocator_type& allocator)
+        : members(other.members, allocator), slots(other.slots, allocator) {}
+
+    ObjectJSON(ObjectJSON&& other, const allocator_type& allocator)
+        : members(std::move(other.members), allocator), slots(std::move(other.slots), allocator) {}
+
+    ObjectJSON& operator=(const ObjectJSON& other) = default;
+    ObjectJSON& operator=(ObjectJSON&& other) = default;
+
+    [[nodiscard]] allocator_type get_allocator() const {
+        return members.get_allocator();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return members.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return members.empty();
+    }
+
+    [[nodiscard]] iterator begin() {
+        return members.begin();
+    }
+
+    [[nodiscard]] iterator end() {
+        return members.end();
+    }
+
+    [[nodiscard]] const_iterator begin() const {
+        return members.begin();
+    }
+
+    [[nodiscard]] const_iterator end() const {
+        return members.end();
+    }
+
+    /**
+     *
+     * @param capacity number of members to make room for
+     */
+    void reserve(std::size_t capacity);
+
+    template<typename K>
+    [[nodiscard]] iterator find(const K& key) {
+        return members.begin() + static_cast<std::ptrdiff_t>(position(key));
+    }
+
+    template<typename K>
+    [[nodiscard]] const_iterator find(const K& key) const {
+        return members.begin() + static_cast<std::ptrdiff_t>(position(key));
+    }
+
+    template<typename K>
+    [[nodiscard]] bool contains(const K& key) const {
+        return position(key) != members.size();
+    }
+
+    template<typename K>
+    [[nodiscard]] const ValueJSON& at(const K& key) const {
+        const std::size_t i = position(key);
+        if(i == members.size()) throw std::out_of_range("No member " + std::string(std::string_view(key)));
+        return members[i].second;
+    }
+
+    template<typename K>
+    [[nodiscard]] ValueJSON& at(const K& key) {
+        return const_cast<ValueJSON&>(std::as_const(*this).at(key));
+    }
+
+    /**
+     * Appends a member unless the key is taken
+     *
+     * @param key key of the member
+     * @param value value of the member
+     * @return the member with the key and true if it was appended, false if the key was taken
+     */
+    std::pair<iterator, bool> try_emplace(KeyJSON key, ValueJSON value);
+};
+
+/**
+ * JSON array. Arrays of only integers or only floating point numbers are stored as a column of the bare numbers,
+ * 8 bytes per item instead of a value each, so they take half the memory and can be read as a span.
+ * Other arrays hold their items as values. An array becomes a column when its first item is a number
+ * and goes back to values when an item of another type is appended
+ */
+class ArrayJSON {
+    // the items, or the numbers of an array of only integers or only floating point numbers
+    std::variant<std::pmr::vector<ValueJSON>, std::pmr::vector<long long>, std::pmr::vector<double>> items;
+
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    ArrayJSON() = default;
+
+    explicit ArrayJSON(const allocator_type& allocator)
+        : items(std::in_place_index<0>, allocator) {}
+
+    ArrayJSON(const ArrayJSON& other) = default;
+    ArrayJSON(ArrayJSON&& other) noexcept = default;
+
+    ArrayJSON(const ArrayJSON& other, const allocator_type& allocator);
+    ArrayJSON(ArrayJSON&& other, const allocator_type& allocator);
+
+    ArrayJSON& operator=(const ArrayJSON& other) = default;
+    ArrayJSON& operator=(ArrayJSON&& other) = default;
+
+    [[nodiscard]] allocator_type get_allocator() const {
+        return std::visit([](const auto& vector) { return allocator_type(vector.get_allocator()); }, items);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return std::visit([](const auto& vector) { return vector.size(); }, items);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     *
+     * @return INT or FLOAT if the array is a column of numbers of that type, typeNULL if it holds values
+     */
+    [[nodiscard]] TypeJSON column() const {
+        switch(items.index()) {
+            case 1: return INT;
+            case 2: return FLOAT;
+            default: return typeNULL;
+        }
+    }
+
+    /**
+     *
+     * @return the items of an array that holds values, empty for a column
+     */
+    [[nodiscard]] std::span<const ValueJSON> values() const {
+        const auto* values = std::get_if<0>(&items);
+        return values != nullptr ? std::span<const ValueJSON>(*values) : std::span<const ValueJSON>();
+    }
+
+    /**
+     *
+     * @return the numbers of a column of integers, empty otherwise
+     */
+    [[nodiscard]] std::span<const long long> integers() const {
+        const auto* integers = std::get_if<1>(&items);
+        return integers != nullptr ? std::span<const long long>(*integers) : std::span<const long long>();
+    }
+
+    /**
+     *
+     * @return the numbers of a column of floating point numbers, empty otherwise
+     */
+    [[nodiscard]] std::span<const double> floats() const {
+        const auto* floats = std::get_if<2>(&items);
+        return floats != nullptr ? std::span<const double>(*floats) : std::span<const double>();
+    }
+
+    /**
+     * Item of an array that holds values, columns have no values to refer to, see item
+     *
+     * @param index index of the item
+     * @return the item
+     */
+    [[nodiscard]] const ValueJSON& at(std::size_t index) const;
+
+    /**
+     *
+     * @param index index of the item
+     * @return copy of the item, made from the number if the array is a column
+     */
+    [[nodiscard]] ValueJSON item(std::size_t index) const;
+
+    /**
+     *
+     * @param capacity number of items to make room for
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * Appends an item, turning the array into a column or back into values if needed
+     *
+     * @param value the item
+     */
+    void push_back(ValueJSON value);
+};
+
+/**
+ * Appends the JSON text of the value, the whole value is serialized into the one buffer
+ *
+ * @param out buffer to append to
+ * @param value value to serialize
+ */
+void appendJSON(std::string& out, const ValueJSON& value);
+
+/**
+ * Writes the JSON text of the value to the stream in chunks, so only about a chunk of the output is held at once
+ *
+ * @param out stream to write to
+ * @param value value to serialize
+ */
+void writeJSON(std::ostream& out, const ValueJSON& value);
+
+/**
+ *
+ * @param value value to serialize
+ * @return JSON text of the value
+ */
 std::string toString(const ValueJSON& value);
 
 #endif //VALUE_H
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "../src/JSON.h"
+
+using namespace std;
+
+/**
+ *
+ * @param expressions expressions of the batch
+ * @return batch compiled without a cache
+ */
+Batch batchOf(const vector<string>& expressions) {
+    vector<shared_ptr<const Bytecode>> programs;
+    for(const string& expression : expressions) {
+        programs.push_back(make_shared<const Bytecode>(compileExpression(parseExpression(expression))));
+    }
+    return compileBatch(std::move(programs));
+}
+
+TEST(Batch, sameAsOneByOne) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const vector<string> expressions = {
+        "person.name", "person.age * 2 + 1", "person.education.college.degrees[1].gpa",
+        "person.education.college.degrees[0].gpa", "size(project.versions)", "max(1, 2.5, person.age)",
+        "person.hobbies[1].equipment.lenses[person.age - 34]", "person.hobbies[size(person.hobbies) - 1]",
+        "person.contacts.phone_numbers", "person", "7", "person.name"
+    };
+    for(const LoadJSON load : {EAGER, LAZY, TAPE}) {
+        const JSON json = JSON(filePath, load);
+        const vector<ResultJSON> results = json.evaluateMany(expressions);
+        ASSERT_EQ(expressions.size(), results.size());
+        for(size_t i = 0; i < expressions.size(); i++) {
+            ASSERT_EQ(toString(json.evaluate(expressions[i])), toString(results[i])) << expressions[i];
+        }
+    }
+}
+
+TEST(Batch, sharedPrefixes) {
+    ASSERT_EQ(5, batchOf({"a.b[0]", "a.b[1]"}).trie.size()); // the entire JSON, a, b and both items
+    ASSERT_EQ(5, batchOf({"a.b[0]", "size(a.b)", "max(a.b[1], a.b[0])"}).trie.size());
+    ASSERT_EQ(3, batchOf({"a.b[a.b[0]].c", "a.b"}).trie.size()); // the computed subscript goes on from b on its own
+
+    const DocumentJSON document(make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/test.json"));
+    const vector<ResultJSON> results = executeBatch(document.root(),
+        batchOf({"a.b[0]", "a.b[1]", "size(a.b)", "max(a.b[3])", "a.b[a.b[1]].c", "a.b[3][a.b[0]]"}));
+    ASSERT_EQ(1, results[0]->asInt());
+    ASSERT_EQ(2, results[1]->asInt());
+    ASSERT_EQ(4, results[2]->asInt());
+    ASSERT_EQ(12, results[3]->asInt());
+    ASSERT_EQ("test", results[4]->asString());
+    ASSERT_EQ(12, results[5]->asInt());
+}
+
+TEST(Batch, pathsAreBorrowed) {
+    const JSON json = JSON(string(TEST_DATA_DIR) + "/test.json");
+    const vector<ResultJSON> results = json.evaluateMany({"a.b[2]", "a.b[3][0]", "a.b[a.b[0]]", "a.b[0] + 1"});
+    ASSERT_EQ(&*json.evaluate("a.b[2]"), &*results[0]);
+    ASSERT_FALSE(results[1].isBorrowed()); // item of a column of numbers
+    ASSERT_EQ(11, results[1]->asInt());
+    ASSERT_EQ(&*json.evaluate("a.b[1]"), &*results[2]);
+    ASSERT_FALSE(results[3].isBorrowed());
+}
+
+TEST(Batch, sameErrors) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    for(const LoadJSON load : {EAGER, LAZY, TAPE}) {
+        const JSON json = JSON(filePath, load);
+        for(const string expression : {"b", "a.c", "a.b.c", "a[0]", "a.b[4]", "a.b[-1]", "a.b[0].c", "a.b[2][0]",
+                                       "a.b[3][0].x", "a.b[a.x]", "a.b[a.b[7]]", "size(a.b[0])", "max(a.b[2], 1)",
+                                       "a.b[size(a.b[0])].c"}) {
+            string one, many;
+            try {
+                json.evaluate(expression);
+            } catch (const executeException& e) {
+                one = e.what();
+            }
+            try {
+                json.evaluateMany({"a.b[0]", expression, "a.x"});
+            } catch (const executeException& e) {
+                many = e.what();
+            }
+            ASSERT_FALSE(one.empty()) << expression;
+            ASSERT_EQ(one, many) << expression;
+        }
+    }
+}
+
+TEST(Batch, repeated) {
+    const JSON json = JSON(string(TEST_DATA_DIR) + "/test.json");
+    const Batch batch = json.compileMany({"a.b[1]", "a.b[2].c", "a.b[1] * 3"});
+    for(int i = 0; i < 3; i++) {
+        const vector<ResultJSON> results = json.evaluateMany(batch);
+        ASSERT_EQ(2, results[0]->asInt());
+        ASSERT_EQ("test", results[1]->asString());
+        ASSERT_EQ(6, results[2]->asInt());
+    }
+    ASSERT_EQ(3, json.cacheStats().misses);
+    ASSERT_TRUE(json.evaluateMany(vector<string>{}).empty());
+}
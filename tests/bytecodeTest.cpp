@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "../src/JSON.h"
+#include "resultOrError.h"
+
+using namespace std;
+
+TEST(Bytecode, sameAsTreeWalk) {
+    const DocumentJSON document(make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/complex/everything.json"));
+    for(const string expression : {"person.name", "person.contacts.phone_numbers", "person.age * 2 + 1",
+                                   "person.education.college.degrees[1].gpa", "size(project.versions)",
+                                   "person.hobbies[1].equipment.lenses[person.age - 34]", "max(1, 2.5, person.age)",
+                                   "min(person.age, 3) ^ 2", "person", "7", "1.5 - 2",
+                                   "person.hobbies[size(person.hobbies) - 1]"}) {
+        const string tree = resultOrError([&] { return executeExpression(document.root(), parseExpression(expression)); });
+        const string bytecode = resultOrError([&] {
+            return executeBytecode(document.root(), compileExpression(parseExpression(expression)));
+        });
+        ASSERT_EQ(tree, bytecode) << expression;
+    }
+}
+
+TEST(Bytecode, sameErrors) {
+    const DocumentJSON document(make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/test.json"));
+    for(const string expression : {"b", "a.c", "a.b.c", "a[0]", "a.b[4]", "a.b[-1]", "a.b[1.5]", "a.b[0].c",
+                                   "a.b[2][0]", "a.b[3][0].x", "a.b[a.x]", "a.b[a.b[7]]", "size(a.b[0])",
+                                   "max(a.b[2], 1)", "a.b[size(a.b[0])].c"}) {
+        const string tree = resultOrError([&] { return executeExpression(document.root(), parseExpression(expression)); });
+        const string bytecode = resultOrError([&] {
+            return executeBytecode(document.root(), compileExpression(parseExpression(expression)));
+        });
+        ASSERT_EQ(tree, bytecode) << expression;
+    }
+}
+
+TEST(Bytecode, pathsAreBorrowed) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    const Bytecode program = compileExpression(parseExpression("a.b[a.b[0]]"));
+    ASSERT_EQ(&*json.evaluate("a.b[1]"), &*json.evaluate(program));
+    ASSERT_FALSE(json.evaluate(compileExpression(parseExpression("a.b[3][1]"))).isBorrowed());
+    for(const LoadJSON load : {EAGER, LAZY, TAPE}) {
+        ASSERT_EQ(2, JSON(filePath, load).evaluate(program)->asInt());
+    }
+}
+
+TEST(Bytecode, stackSize) {
+    ASSERT_EQ(1, compileExpression(parseExpression("a.b.c")).stackSize);
+    ASSERT_EQ(2, compileExpression(parseExpression("a.b[1]")).stackSize);
+    ASSERT_EQ(3, compileExpression(parseExpression("max(a, b, c)")).stackSize);
+    ASSERT_EQ(4, compileExpression(parseExpression("a + b[c[1]]")).stackSize);
+    string expression = "person.age";
+    for(int i = 1; i < 18; i++) expression = "person.age + (" + expression + ")";
+    const Bytecode deep = compileExpression(parseExpression(expression));
+    ASSERT_EQ(18, deep.stackSize);
+    const DocumentJSON document(make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/complex/everything.json"));
+    ASSERT_EQ(18 * 35, executeBytecode(document.root(), deep)->asInt());
+}
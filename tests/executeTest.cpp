@@ -7,7 +7,7 @@ using namespace std;
 TEST(TrivialPath, first) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(2, get<long long>(json.evaluate("a.b[1]").value));
+    ASSERT_EQ(2, json.evaluate("a.b[1]")->asInt());
 }
 
 TEST(TrivialPath, second) {
@@ -31,89 +31,211 @@ TEST(Path, subExpression) {
 TEST(FunctionMax, max) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(2, get<long long>(json.evaluate("max(a.b[0], a.b[1])").value));
+    ASSERT_EQ(2, json.evaluate("max(a.b[0], a.b[1])")->asInt());
 }
 
 TEST(FunctionMin, min) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(11, get<long long>(json.evaluate("min(a.b[3])").value));
+    ASSERT_EQ(11, json.evaluate("min(a.b[3])")->asInt());
 }
 
 TEST(FunctionSize, first) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(1, get<long long>(json.evaluate("size(a)").value));
+    ASSERT_EQ(1, json.evaluate("size(a)")->asInt());
 }
 
 TEST(FunctionSize, second) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(4, get<long long>(json.evaluate("size(a.b)").value));
+    ASSERT_EQ(4, json.evaluate("size(a.b)")->asInt());
 }
 
 TEST(FunctionSize, third) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(4, get<long long>(json.evaluate("size(a.b[a.b[1]].c)").value));
+    ASSERT_EQ(4, json.evaluate("size(a.b[a.b[1]].c)")->asInt());
 }
 
 TEST(FunctionMax, withLiterals) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(15, get<long long>(json.evaluate("max(a.b[0], 10, a.b[1], 15)").value));
+    ASSERT_EQ(15, json.evaluate("max(a.b[0], 10, a.b[1], 15)")->asInt());
+}
+
+TEST(FunctionSum, sum) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    ASSERT_EQ(23, json.evaluate("sum(a.b[3])")->asInt());
+    ASSERT_EQ(13, json.evaluate("sum(a.b[0], 10, a.b[1])")->asInt());
+    ASSERT_DOUBLE_EQ(3.5, json.evaluate("sum(a.b[0], 2.5)")->asDouble());
+    ASSERT_EQ(FLOAT, json.evaluate("sum(9223372036854775807, 1)")->type); // integer overflow
+    ASSERT_DOUBLE_EQ(9223372036854775808.0, json.evaluate("sum(9223372036854775807, 1)")->asDouble());
+    ASSERT_THROW(json.evaluate("sum(a.b)"), executeException);
+    ASSERT_THROW(json.evaluate("sum(a.b[0], a)"), executeException);
+}
+
+TEST(FunctionAvg, avg) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    ASSERT_EQ(FLOAT, json.evaluate("avg(a.b[3])")->type);
+    ASSERT_DOUBLE_EQ(11.5, json.evaluate("avg(a.b[3])")->asDouble());
+    ASSERT_DOUBLE_EQ(1.5, json.evaluate("avg(a.b[0], a.b[1])")->asDouble());
+    ASSERT_THROW(json.evaluate("avg(a.b[2].c)"), executeException);
+}
+
+TEST(FunctionCount, count) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    ASSERT_EQ(2, json.evaluate("count(a.b)")->asInt()); // only the numbers, unlike size
+    ASSERT_EQ(2, json.evaluate("count(a.b[3])")->asInt());
+    ASSERT_EQ(2, json.evaluate("count(a.b[0], a.b[2].c, 1.5)")->asInt());
+}
+
+TEST(FunctionStddev, stddev) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    ASSERT_DOUBLE_EQ(0.5, json.evaluate("stddev(a.b[3])")->asDouble());
+    ASSERT_DOUBLE_EQ(1.118033988749895, json.evaluate("stddev(1, 2, 3, 4)")->asDouble());
+    ASSERT_DOUBLE_EQ(0, json.evaluate("stddev(a.b[1])")->asDouble());
+    ASSERT_THROW(json.evaluate("stddev(a)"), executeException);
 }
 
 TEST(Arithmetic, addAtPaths) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(3, get<long long>(json.evaluate("a.b[0] + a.b[1]").value));
+    ASSERT_EQ(3, json.evaluate("a.b[0] + a.b[1]")->asInt());
 }
 
 TEST(Arithmetic, addLiterals) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(4, get<long long>(json.evaluate("1  +3").value));
+    ASSERT_EQ(4, json.evaluate("1  +3")->asInt());
 }
 
 TEST(Arithmetic, addWithLiterals) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(6, get<long long>(json.evaluate("1 + a.b[1] + 3").value));
+    ASSERT_EQ(6, json.evaluate("1 + a.b[1] + 3")->asInt());
 }
 
 TEST(Arithmetic, addNegativeLiteral) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(-2, get<long long>(json.evaluate("1 + -3").value));
+    ASSERT_EQ(-2, json.evaluate("1 + -3")->asInt());
 }
 
 TEST(Arithmetic, mix) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(6, get<long long>(json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 2^2").value));
+    ASSERT_EQ(6, json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 2^2")->asInt());
 }
 
 TEST(Arithmetic, mixFloat) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_FLOAT_EQ(4.6, get<double>(json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 5.5 - 0.4").value));
+    ASSERT_FLOAT_EQ(4.6, json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 5.5 - 0.4")->asDouble());
 }
 
 TEST(Arithmetic, justParentheses) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(5, get<long long>(json.evaluate("(5)").value));
+    ASSERT_EQ(5, json.evaluate("(5)")->asInt());
 }
 
 TEST(Arithmetic, parentheses) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(9, get<long long>(json.evaluate("(1+2 * (3 + 2*-1))^2").value));
+    ASSERT_EQ(9, json.evaluate("(1+2 * (3 + 2*-1))^2")->asInt());
 }
 
 TEST(Arithmetic, mixParentheses) {
     const string filePath = string(TEST_DATA_DIR) + "/test.json";
     const JSON json = JSON(filePath);
-    ASSERT_EQ(15, get<long long>(json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 2^2 + (1+2 * (3 + 2*-1))^2").value));
-}
\ No newline at end of file
+    ASSERT_EQ(15, json.evaluate("a.b[0] + a.b[ 1 ] * a.b[a.b[0] + a.b[1]][0] / 2^2 + (1+2 * (3 + 2*-1))^2")->asInt());
+}
+
+// paths are references into the eagerly parsed JSON
+TEST(Results, pathsAreBorrowed) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const JSON json = JSON(filePath);
+    const ResultJSON array = json.evaluate("a.b");
+    ASSERT_TRUE(array.isBorrowed());
+    ASSERT_EQ(&*array, &*json.evaluate("a.b"));
+    ASSERT_EQ(&array->asArray().at(2), &*json.evaluate("a.b[2]"));
+    ASSERT_TRUE(json.evaluate("a.b[2].c").isBorrowed());
+    ASSERT_FALSE(json.evaluate("a.b[3][0]").isBorrowed()); // item of a column of numbers
+    ASSERT_FALSE(json.evaluate("a.b[0] + 1").isBorrowed());
+    ASSERT_FALSE(JSON(filePath, LAZY).evaluate("a.b").isBorrowed());
+    ASSERT_FALSE(JSON(filePath, TAPE).evaluate("a.b").isBorrowed());
+    const ValueJSON copy = json.evaluate("a.b[2]").release();
+    ASSERT_NE(&copy, &*json.evaluate("a.b[2]"));
+    ASSERT_EQ("test", copy.asObject().at("c").asString());
+}
+
+// arrays of numbers of one type are stored as columns
+TEST(Columns, sameResults) {
+    const string filePath = string(TEST_DATA_DIR) + "/columns.json";
+    for(const LoadJSON load : {EAGER, LAZY, TAPE}) {
+        const JSON json = JSON(filePath, load);
+        ASSERT_EQ(5000000000, json.evaluate("ints[2]")->asInt());
+        ASSERT_EQ(5000000000, json.evaluate("max(ints)")->asInt());
+        ASSERT_EQ(-7, json.evaluate("min(ints)")->asInt());
+        ASSERT_DOUBLE_EQ(-1.25, json.evaluate("min(floats)")->asDouble());
+        ASSERT_EQ(FLOAT, json.evaluate("max(mixed)")->type);
+        ASSERT_DOUBLE_EQ(3, json.evaluate("max(mixed)")->asDouble());
+        ASSERT_EQ(3, json.evaluate("size(tail)")->asInt());
+        ASSERT_STREQ("[ 3, -7, 5000000000, 2 ]", toString(json.evaluate("ints")).c_str());
+        ASSERT_STREQ("[ 1, 2, \"three\" ]", toString(json.evaluate("tail")).c_str());
+        ASSERT_THROW(json.evaluate("ints[1].a"), pathException);
+        ASSERT_THROW(json.evaluate("floats[0][0]"), pathException);
+        ASSERT_THROW(json.evaluate("ints[4]"), pathException);
+        ASSERT_THROW(json.evaluate("max(tail)"), executeException);
+        ASSERT_EQ(4999999998, json.evaluate("sum(ints)")->asInt());
+        ASSERT_DOUBLE_EQ(4.25, json.evaluate("sum(floats)")->asDouble());
+        ASSERT_DOUBLE_EQ(6.5 / 3, json.evaluate("avg(mixed)")->asDouble());
+        ASSERT_EQ(2, json.evaluate("count(tail)")->asInt());
+        ASSERT_THROW(json.evaluate("sum(tail)"), executeException);
+    }
+}
+
+// Lazy mode parses only the paths the expression visits
+TEST(Lazy, sameAsEager) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const JSON eager = JSON(filePath);
+    const JSON lazy = JSON(filePath, LAZY);
+    for(const string expression : {"person.contacts.phone_numbers", "person.education.college.degrees[1].gpa",
+                                   "size(project.versions)", "person.hobbies[1].equipment.lenses[person.age - 34]",
+                                   "max(person.financials.credit_cards[0].limit, project.repository.stars) + 1"}) {
+        ASSERT_STREQ(toString(eager.evaluate(expression)).c_str(), toString(lazy.evaluate(expression)).c_str());
+    }
+}
+
+TEST(Lazy, missingKey) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const JSON json = JSON(filePath, LAZY);
+    ASSERT_THROW(json.evaluate("person.contacts.fax"), pathException);
+}
+
+// the tape backend gives the same results as the tree
+TEST(Tape, sameAsEager) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const JSON eager = JSON(filePath);
+    const JSON tape = JSON(filePath, TAPE);
+    for(const string expression : {"person.contacts.phone_numbers", "person.education.college.degrees[1].gpa",
+                                   "size(project.versions)", "person.hobbies[1].equipment.lenses[person.age - 34]",
+                                   "max(person.financials.credit_cards[0].limit, project.repository.stars) + 1",
+                                   "person", "min(person.age, 2.5)"}) {
+        ASSERT_STREQ(toString(eager.evaluate(expression)).c_str(), toString(tape.evaluate(expression)).c_str());
+    }
+}
+
+TEST(Tape, wrongPaths) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const JSON json = JSON(filePath, TAPE);
+    ASSERT_THROW(json.evaluate("person.contacts.fax"), pathException);
+    ASSERT_THROW(json.evaluate("person.hobbies[100]"), pathException);
+    ASSERT_THROW(json.evaluate("person.hobbies[-1]"), pathException);
+    ASSERT_THROW(json.evaluate("person.hobbies.equipment"), pathException);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "../src/JSON.h"
+
+using namespace std;
+
+TEST(ExpressionCache, normalize) {
+    ASSERT_EQ("a.b[1]", normalizeExpression("a.b[1]"));
+    ASSERT_EQ("a.b[1] + 2", normalizeExpression(" \ta.b[1]   +\n2  "));
+    ASSERT_EQ("max(1, 2)", normalizeExpression("max(1,  2)"));
+    ASSERT_EQ("", normalizeExpression("   "));
+}
+
+TEST(ExpressionCache, hitsAndMisses) {
+    ExpressionCache cache;
+    const shared_ptr<const Bytecode> first = cache.compile("a.b[1] + 2");
+    ASSERT_EQ(first, cache.compile("a.b[1] + 2"));
+    ASSERT_EQ(first, cache.compile("  a.b[1]  +\t2 "));
+    ASSERT_NE(first, cache.compile("a.b[1]+2")); // another text, not normalized to the same
+    const ExpressionCache::Stats stats = cache.stats();
+    ASSERT_EQ(2, stats.hits);
+    ASSERT_EQ(2, stats.misses);
+    ASSERT_EQ(2, stats.size);
+}
+
+TEST(ExpressionCache, leastRecentlyUsed) {
+    ExpressionCache cache(2);
+    const auto a = cache.compile("a");
+    const auto b = cache.compile("b");
+    ASSERT_EQ(a, cache.compile("a"));
+    const auto c = cache.compile("c"); // drops b, a was used after it
+    ASSERT_EQ(2, cache.stats().size);
+    ASSERT_EQ(a, cache.compile("a"));
+    ASSERT_EQ(c, cache.compile("c"));
+    ASSERT_NE(b, cache.compile("b"));
+    ASSERT_EQ("b", get<string>(b->expression.value)); // still valid after it was dropped
+    ASSERT_EQ(3, cache.stats().hits);
+    ASSERT_EQ(4, cache.stats().misses);
+}
+
+TEST(ExpressionCache, nothingKept) {
+    ExpressionCache cache(0);
+    ASSERT_NE(cache.compile("a"), cache.compile("a"));
+    ASSERT_EQ(0, cache.stats().size);
+    ASSERT_EQ(2, cache.stats().misses);
+}
+
+TEST(ExpressionCache, parseErrorsNotKept) {
+    ExpressionCache cache;
+    string first, second;
+    try {
+        cache.compile("a.b[1");
+    } catch (const ExpressionParseException& e) {
+        first = e.what();
+    }
+    try {
+        cache.compile(" a.b[1");
+    } catch (const ExpressionParseException& e) {
+        second = e.what();
+    }
+    ASSERT_FALSE(first.empty());
+    ASSERT_NE(first, second); // the caret points into the text as written
+    ASSERT_EQ(0, cache.stats().size);
+}
+
+TEST(ExpressionCache, evaluate) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    for(const LoadJSON load : {EAGER, LAZY, TAPE}) {
+        const JSON json = JSON(filePath, load);
+        for(int i = 0; i < 3; i++) {
+            ASSERT_EQ(4, json.evaluate("a.b[1] + 2")->asInt());
+            ASSERT_EQ(4, json.evaluate(" a.b[1] + 2 ")->asInt());
+            ASSERT_THROW(json.evaluate("a.b[4]"), pathException);
+        }
+        ASSERT_EQ(7, json.cacheStats().hits);
+        ASSERT_EQ(2, json.cacheStats().misses); // both spellings of the sum are one entry
+    }
+    const JSON uncached = JSON(filePath, EAGER, 1, 0);
+    ASSERT_EQ(2, uncached.evaluate("a.b[1]")->asInt());
+    ASSERT_EQ(2, uncached.evaluate("a.b[1]")->asInt());
+    ASSERT_EQ(0, uncached.cacheStats().hits);
+}
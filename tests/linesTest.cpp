@@ -0,0 +1,35 @@
+#include "../src/lines.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace std;
+
+TEST(Lines, resultPerRecord) {
+    ifstream in(string(TEST_DATA_DIR) + "/lines/records.jsonl", ios::binary);
+    stringstream out;
+    evaluateLines(in, out, "size(a.b)", 1);
+    ASSERT_STREQ("2\n3\n4\n1\n", out.str().c_str());
+}
+
+TEST(Lines, errorLine) {
+    ifstream in(string(TEST_DATA_DIR) + "/lines/records.jsonl", ios::binary);
+    stringstream out;
+    evaluateLines(in, out, "a.b[0]", 1);
+    ASSERT_EQ(0, out.str().find("1\n3\nerror: This path should be an array"));
+    ASSERT_TRUE(out.str().ends_with("\n6\n"));
+}
+
+TEST(Lines, threadsKeepOrder) {
+    string records;
+    string expected;
+    for(int i = 0; i < 500; i++) {
+        records += R"({"i": )" + to_string(i) + "}\n";
+        expected += to_string(i * 2) + '\n';
+    }
+    stringstream in(records);
+    stringstream out;
+    evaluateLines(in, out, "i * 2", 4, 64);
+    ASSERT_STREQ(expected.c_str(), out.str().c_str());
+}
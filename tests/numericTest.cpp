@@ -0,0 +1,94 @@
+#include "../src/numeric.h"
+
+#include <climits>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "../src/JSON.h"
+
+using namespace std;
+
+TEST(Numeric, matchesScalar) {
+    mt19937_64 random(3);
+    uniform_int_distribution<long long> integers(LLONG_MIN, LLONG_MAX);
+    uniform_real_distribution<double> floats(-1e300, 1e300);
+    // sizes around the 16 numbers of one step of the vectorized loop, so every tail is covered
+    for(size_t size = 1; size < 100; size++) {
+        vector<long long> ints(size);
+        vector<double> doubles(size);
+        for(size_t i = 0; i < size; i++) {
+            ints[i] = integers(random);
+            doubles[i] = floats(random);
+        }
+        for(const bool largest : {true, false}) {
+            ASSERT_EQ(findExtremeScalar(ints, largest), findExtreme(ints, largest)) << size;
+            ASSERT_EQ(findExtremeScalar(doubles, largest), findExtreme(doubles, largest)) << size;
+        }
+    }
+    // 0.0 and -0.0 compare equal, the first one of them is kept like the scalar loop does
+    for(size_t size = 1; size < 70; size++) {
+        vector<double> zeros(size);
+        for(size_t i = 0; i < size; i++) zeros[i] = random() % 2 == 0 ? 0.0 : -0.0;
+        for(const bool largest : {true, false}) {
+            ASSERT_EQ(signbit(findExtremeScalar(zeros, largest)), signbit(findExtreme(zeros, largest))) << size;
+            ASSERT_EQ(signbit(zeros[0]), signbit(findExtreme(zeros, largest))) << size;
+        }
+    }
+}
+
+TEST(Numeric, extremesAnywhere) {
+    for(size_t position = 0; position < 40; position++) {
+        vector<long long> ints(40, 5);
+        vector<double> doubles(40, 0.5);
+        ints[position] = LLONG_MIN;
+        doubles[position] = INFINITY;
+        ASSERT_EQ(LLONG_MIN, findExtreme(ints, false)) << position;
+        ASSERT_EQ(5, findExtreme(ints, true)) << position;
+        ASSERT_EQ(INFINITY, findExtreme(doubles, true)) << position;
+        ASSERT_EQ(0.5, findExtreme(doubles, false)) << position;
+    }
+}
+
+TEST(Numeric, instructionSet) {
+    const string name = numericInstructionSet();
+    ASSERT_TRUE(name == "avx2" || name == "scalar");
+}
+
+TEST(Numeric, beyondIntRange) {
+    const JSON json = JSON(string(TEST_DATA_DIR) + "/test.json");
+    ASSERT_EQ(-5000000000, json.evaluate("max(0 - 5000000000, 0 - 6000000000)")->asInt());
+    ASSERT_EQ(5000000000, json.evaluate("min(5000000000, 6000000000)")->asInt());
+    ASSERT_EQ(FLOAT, json.evaluate("max(0 - 5000000000, 0 - 7.5)")->type);
+    ASSERT_DOUBLE_EQ(-7.5, json.evaluate("max(0 - 5000000000, 0 - 7.5)")->asDouble());
+    ASSERT_DOUBLE_EQ(-5e9, json.evaluate("min(0 - 5000000000, 0 - 7.5)")->asDouble());
+}
+
+TEST(Numeric, compensatedSum) {
+    CompensatedSum sum;
+    double naive = 0;
+    for(const double number : {1e16, 1.0, -1e16, 1.0}) {
+        sum.add(number);
+        naive += number;
+    }
+    ASSERT_EQ(2, sum.value());
+    ASSERT_EQ(1, naive); // the first 1 is rounded off
+    CompensatedSum many;
+    for(int i = 0; i < 1000000; i++) many.add(0.1);
+    ASSERT_EQ(100000, many.value());
+}
+
+TEST(Numeric, aggregatesOfColumns) {
+    string document = R"({"ints": [)";
+    for(int i = 1; i <= 1000; i++) document += (i > 1 ? "," : "") + to_string(i);
+    document += R"(], "tenths": [)";
+    for(int i = 0; i < 100000; i++) document += i > 0 ? ",0.1" : "0.1";
+    document += "]}";
+    const ObjectJSON JSON = parseJSON(document);
+    ASSERT_EQ(500500, executeExpression(JSON, parseExpression("sum(ints)"))->asInt());
+    ASSERT_DOUBLE_EQ(500.5, executeExpression(JSON, parseExpression("avg(ints)"))->asDouble());
+    ASSERT_EQ(1000, executeExpression(JSON, parseExpression("count(ints)"))->asInt());
+    ASSERT_DOUBLE_EQ(sqrt((1000.0 * 1000 - 1) / 12), executeExpression(JSON, parseExpression("stddev(ints)"))->asDouble());
+    ASSERT_EQ(10000, executeExpression(JSON, parseExpression("sum(tenths)"))->asDouble());
+}
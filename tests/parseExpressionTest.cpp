@@ -56,6 +56,23 @@ TEST(NumberLiteral, simpleNumber) {
     EXPECT_EQ(INT_LITERAL, actual.action);
 }
 
+TEST(NumberLiteral, floatNumber) {
+    const Node actual = parseExpression("1.5e2");
+    EXPECT_DOUBLE_EQ(150, get<double>(actual.value));
+    EXPECT_EQ(FLOAT_LITERAL, actual.action);
+}
+
+TEST(NumberLiteral, negativeInArithmetic) {
+    const Node actual = parseExpression("2*-10");
+    EXPECT_EQ(MULTIPLY, actual.action);
+    EXPECT_EQ(-10, get<long long>(actual.children.at(1).value));
+}
+
+TEST(NumberLiteral, invalid) {
+    EXPECT_THROW(parseExpression("1 + -a"), ExpressionParseException);
+    EXPECT_THROW(parseExpression("3."), ExpressionParseException);
+}
+
 TEST(Subscript, simple) {
     const Node actual = parseExpression("a[1]");
     EXPECT_STREQ("a", get<std::string>(actual.value).c_str());
@@ -227,4 +244,29 @@ TEST(SizeFunction, oneArgExtraWS) {
     EXPECT_EQ(1, actual.children.size());
     EXPECT_EQ(IDENTIFIER, actual.children.at(0).action);
     EXPECT_STREQ("ab", get<std::string>(actual.children.at(0).value).c_str());
-}
\ No newline at end of file
+}
+TEST(Whitespace, betweenTokens) {
+    const Node actual = parseExpression(" \ta . b [ 1 +\n2 ] . c  ");
+    EXPECT_EQ(GET_MEMBER, actual.action);
+    const Node& subscript = actual.children.at(0);
+    EXPECT_EQ(GET_SUBSCRIPT, subscript.action);
+    EXPECT_EQ(ADD, subscript.children.at(0).subscript->action);
+    EXPECT_STREQ("c", get<std::string>(subscript.children.at(0).children.at(0).value).c_str());
+}
+
+TEST(Whitespace, splitsTokens) {
+    EXPECT_THROW(parseExpression("a b"), ExpressionParseException);
+    EXPECT_THROW(parseExpression("1 2"), ExpressionParseException);
+    EXPECT_THROW(parseExpression("a.b c"), ExpressionParseException);
+}
+
+TEST(Whitespace, afterUnaryMinus) {
+    const Node literal = parseExpression("- 1");
+    EXPECT_EQ(INT_LITERAL, literal.action);
+    EXPECT_EQ(-1, get<long long>(literal.value));
+    const Node product = parseExpression("2 * - 3");
+    EXPECT_EQ(MULTIPLY, product.action);
+    EXPECT_EQ(-3, get<long long>(product.children.at(1).value));
+    EXPECT_EQ(-1.5, get<double>(parseExpression("-  1.5").value));
+    EXPECT_THROW(parseExpression("1 - - a.b"), ExpressionParseException);
+}
@@ -1,69 +1,91 @@
+#include "../src/input.h"
 #include "../src/parseJSON.h"
 #include "../src/value.h"
 
 #include <gtest/gtest.h>
+#include <optional>
+#include <sstream>
 
 using namespace std;
 
 //Simple valid
 TEST(ParseSimple, empty) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/empty.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(result.size(), 0);
 }
 
 TEST(ParseSimple, string) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/string.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("string"));
     ASSERT_EQ(STRING, result.at("string").type);
-    ASSERT_STREQ("something", get<string>(result.at("string").value).c_str());
+    ASSERT_EQ("something", result.at("string").asString());
 }
 
 TEST(ParseSimple, integer) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/number.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("integer"));
     ASSERT_EQ(INT, result.at("integer").type);
-    ASSERT_EQ(5, get<long long>(result.at("integer").value));
+    ASSERT_EQ(5, result.at("integer").asInt());
 }
 
 TEST(ParseSimple, negativeInt) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/number.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("negativeInt"));
     ASSERT_EQ(INT, result.at("negativeInt").type);
-    ASSERT_EQ(-6, get<long long>(result.at("negativeInt").value));
+    ASSERT_EQ(-6, result.at("negativeInt").asInt());
 }
 
 TEST(ParseSimple, floating) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/number.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("floating"));
     ASSERT_EQ(FLOAT, result.at("floating").type);
-    ASSERT_FLOAT_EQ(0.12, get<double>(result.at("floating").value));
+    ASSERT_FLOAT_EQ(0.12, result.at("floating").asDouble());
 }
 
 TEST(ParseSimple, negativeFloat) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/number.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("negativeFloat"));
     ASSERT_EQ(FLOAT, result.at("negativeFloat").type);
-    ASSERT_FLOAT_EQ(-12.002, get<double>(result.at("negativeFloat").value));
+    ASSERT_FLOAT_EQ(-12.002, result.at("negativeFloat").asDouble());
 }
 
 TEST(ParseSimple, scaled) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/number.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("scaled"));
     ASSERT_EQ(FLOAT, result.at("scaled").type);
-    ASSERT_FLOAT_EQ(1.0321e-5, get<double>(result.at("scaled").value));
+    ASSERT_FLOAT_EQ(1.0321e-5, result.at("scaled").asDouble());
+}
+
+TEST(ParseNumber, bigIntegerIsFloat) {
+    const ObjectJSON result = parseJSON(R"({"big": 123456789012345678901234567890})");
+    ASSERT_EQ(FLOAT, result.at("big").type);
+    ASSERT_DOUBLE_EQ(1.2345678901234568e29, result.at("big").asDouble());
+}
+
+TEST(ParseNumber, exponentWithoutFraction) {
+    const ObjectJSON result = parseJSON(R"({"number": -2E+3})");
+    ASSERT_EQ(FLOAT, result.at("number").type);
+    ASSERT_DOUBLE_EQ(-2000, result.at("number").asDouble());
+}
+
+TEST(ParseNumber, malformed) {
+    ASSERT_THROW(parseJSON(R"({"number": 1.})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"number": 1e})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"number": 1.2.3})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"number": 012})"), JSONParseException);
 }
 
 TEST(ParseSimple, null) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/null.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("shouldBeNull"));
     ASSERT_EQ(typeNULL, result.at("shouldBeNull").type);
@@ -71,39 +93,39 @@ TEST(ParseSimple, null) {
 
 TEST(ParseSimple, boolTrue) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/boolTrue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("bool"));
     ASSERT_EQ(BOOL, result.at("bool").type);
-    ASSERT_TRUE(get<bool>(result.at("bool").value));
+    ASSERT_TRUE(result.at("bool").asBool());
 }
 
 TEST(ParseSimple, boolFalse) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/boolFalse.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("bool"));
     ASSERT_EQ(BOOL, result.at("bool").type);
-    ASSERT_FALSE(get<bool>(result.at("bool").value));
+    ASSERT_FALSE(result.at("bool").asBool());
 }
 
 TEST(ParseSimple, objectEmpty) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/objectEmpty.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("object"));
     ASSERT_EQ(OBJECT, result.at("object").type);
-    const unordered_map<string, ValueJSON> obj = get<unordered_map<string, ValueJSON>>(result.at("object").value);
+    const ObjectJSON obj = result.at("object").asObject();
     ASSERT_EQ(0, obj.size());
 }
 
 TEST(ParseSimple, arrayEmpty) {
     const string filePath = string(TEST_DATA_DIR) + "/simple/arrayEmpty.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("array"));
     ASSERT_EQ(ARRAY, result.at("array").type);
-    const vector<ValueJSON> array = get<vector<ValueJSON>>(result.at("array").value);
+    const ArrayJSON array = result.at("array").asArray();
     ASSERT_EQ(0, array.size());
 }
 
@@ -125,56 +147,87 @@ TEST(ParseEscapedChar, escapedLastQuoteInKey) {
 
 TEST(ParseEscapedChar, escapedEscapeInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("esc\\ape", get<string>(result.at("escape").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("esc\\ape", result.at("escape").asString());
 }
 
 TEST(ParseEscapedChar, escapedForwardSlashInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("/", get<string>(result.at("forward").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("/", result.at("forward").asString());
 }
 
 TEST(ParseEscapedChar, escapedNewLineInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("top\nbottom", get<string>(result.at("newline").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("top\nbottom", result.at("newline").asString());
 }
 
 TEST(ParseEscapedChar, escapedTabInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("\ttabbed", get<string>(result.at("tab").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("\ttabbed", result.at("tab").asString());
 }
 
 TEST(ParseEscapedChar, escapedBackSpaceInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("b\b", get<string>(result.at("backspace").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("b\b", result.at("backspace").asString());
 }
 
 TEST(ParseEscapedChar, escapedFormFeedInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("\f", get<string>(result.at("form_feed").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("\f", result.at("form_feed").asString());
 }
 
 TEST(ParseEscapedChar, escapedCarriageReturnInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("\r", get<string>(result.at("carriage").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("\r", result.at("carriage").asString());
 }
 
 TEST(ParseEscapedChar, escapedSmileyInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("\u0002", get<string>(result.at("smiley").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("\u0002", result.at("smiley").asString());
 }
 
 TEST(ParseEscapedChar, escapedQuotesInValue) {
     const string filePath = string(TEST_DATA_DIR) + "/escapedChar/escapedInValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("\"citation\"", get<string>(result.at("quote").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("\"citation\"", result.at("quote").asString());
+}
+
+TEST(ParseEscapedChar, unicodeEscapeToUTF8) {
+    const ObjectJSON result = parseJSON(R"({"e": "caf\u00e9", "euro": "\u20AC", "emoji": "\ud83d\ude00"})");
+    ASSERT_EQ("caf\xC3\xA9", result.at("e").asString());
+    ASSERT_EQ("\xE2\x82\xAC", result.at("euro").asString());
+    ASSERT_EQ("\xF0\x9F\x98\x80", result.at("emoji").asString());
+}
+
+TEST(ParseEscapedChar, rawUTF8Kept) {
+    const ObjectJSON result = parseJSON("{\"k\": \"\xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD\"}");
+    ASSERT_EQ("\xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD", result.at("k").asString());
+}
+
+TEST(ParseEscapedChar, escapesAcrossBlocks) {
+    string expected, escaped;
+    for(int i = 0; i < 100; i++) {
+        expected += string(i % 7, 'a') + "\"\n\\";
+        escaped += string(i % 7, 'a') + R"(\"\n\\)";
+    }
+    const ObjectJSON result = parseJSON("{\"k\": \"" + escaped + "\"}");
+    ASSERT_EQ(expected, result.at("k").asString());
+}
+
+TEST(ParseEscapedChar, invalidEscapes) {
+    ASSERT_THROW(parseJSON(R"({"k": "\ud83d"})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"k": "\ude00"})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"k": "\ud83d\u0041"})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"k": "\u00g1"})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"k": "\x"})"), JSONParseException);
+    ASSERT_THROW(parseJSON(R"({"k": "\u00)"), JSONParseException);
 }
 
 // Key in objects
@@ -191,52 +244,382 @@ TEST(ParseEscapedChar, escapedQuoteInKey) {
 // Edge cases
 TEST(EdgeCase, emptyStringValue) {
     const string filePath = string(TEST_DATA_DIR) + "/edgeCases/emptyStringValue.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
-    ASSERT_STREQ("", get<string>(result.at("empty").value).c_str());
+    const ObjectJSON result = parseFileJSON(filePath);
+    ASSERT_EQ("", result.at("empty").asString());
 }
 
 // Unformatted JSON
 TEST(Unformatted, uglyStrings) {
     const string filePath = string(TEST_DATA_DIR) + "/unformatted/uglyStrings.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(3, result.size());
 }
 
+TEST(Unformatted, whitespaceInStringKept) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const ObjectJSON result = parseFileJSON(filePath);
+    const ObjectJSON person = result.at("person").asObject();
+    ASSERT_EQ("John Doe", person.at("name").asString());
+}
+
+// Filtered
+TEST(ParseFiltered, onlyFilteredMembers) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const InputJSON input(filePath);
+    PathFilter filter;
+    filter.members["person"].members["name"].everything = true;
+    const ObjectJSON result = parseJSON(input.view(), filter);
+    ASSERT_EQ(1, result.size());
+    const ObjectJSON person = result.at("person").asObject();
+    ASSERT_EQ(1, person.size());
+    ASSERT_EQ("John Doe", person.at("name").asString());
+}
+
+TEST(ParseFiltered, arrayKeepsItems) {
+    PathFilter filter;
+    filter.members["array"];
+    const ObjectJSON result = parseJSON(R"({"array": [{"a": 1}, [2], 3], "b": 4})", filter);
+    const ArrayJSON array = result.at("array").asArray();
+    ASSERT_EQ(3, array.size());
+    ASSERT_EQ(0, (array.at(0).asObject().size()));
+    ASSERT_EQ(ARRAY, array.at(1).type);
+    ASSERT_EQ(INT, array.at(2).type);
+}
+
+// Parallel
+bool sameValue(const ValueJSON& a, const ValueJSON& b) { // NOLINT(*-no-recursion)
+    if(a.type != b.type) return false;
+    if(a.type == OBJECT) {
+        const auto& objectA = a.asObject();
+        const auto& objectB = b.asObject();
+        if(objectA.size() != objectB.size()) return false;
+        for(const auto& [key, value] : objectA) {
+            if(!objectB.contains(key) || !sameValue(value, objectB.at(key))) return false;
+        }
+        return true;
+    }
+    if(a.type == ARRAY) {
+        const auto& arrayA = a.asArray();
+        const auto& arrayB = b.asArray();
+        if(arrayA.size() != arrayB.size() || arrayA.column() != arrayB.column()) return false;
+        if(arrayA.column() != typeNULL) return toString(a) == toString(b);
+        for(size_t i = 0; i < arrayA.size(); i++) {
+            if(!sameValue(arrayA.at(i), arrayB.at(i))) return false;
+        }
+        return true;
+    }
+    return toString(a) == toString(b);
+}
+
+TEST(ParseParallel, sameAsSequential) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const InputJSON input(filePath);
+    const ValueJSON sequential(parseJSON(input.view()));
+    for(const string::size_type threshold : {16, 64, 512, 4096}) {
+        const ValueJSON parallel(parseJSON(input.view(), 4, threshold));
+        ASSERT_TRUE(sameValue(sequential, parallel));
+    }
+}
+
+TEST(ParseParallel, bigArray) {
+    string json = R"({"small": 1, "array": [)";
+    for(int i = 0; i < 1000; i++) {
+        json += (i > 0 ? "," : "") + string(R"({"i": )") + to_string(i) + "}";
+    }
+    json += "]}";
+    const ObjectJSON result = parseJSON(json, 3, 100);
+    const ArrayJSON array = result.at("array").asArray();
+    ASSERT_EQ(1000, array.size());
+    for(int i = 0; i < 1000; i++) {
+        ASSERT_EQ(i, array.at(i).asObject().at("i").asInt());
+    }
+}
+
+TEST(ParseParallel, duplicateKeysInDifferentBatches) {
+    ASSERT_THROW(parseJSON(R"({"a": "0123456789", "b": "0123456789", "a": 1})", 2, 8), JSONParseException);
+}
+
+TEST(ParseParallel, errorInBatch) {
+    ASSERT_THROW(parseJSON(R"({"a": "0123456789", "b": [1, 2,, 3], "c": 1})", 2, 8), JSONParseException);
+}
+
+// Arena
+TEST(Arena, sameAsHeap) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const InputJSON input(filePath);
+    const ValueJSON heap(parseJSON(input.view()));
+    const DocumentJSON sequential(input.view());
+    ASSERT_TRUE(sameValue(heap, ValueJSON(sequential.root())));
+    const DocumentJSON parallel(input.view(), 4, 64);
+    ASSERT_TRUE(sameValue(heap, ValueJSON(parallel.root())));
+}
+
+TEST(Arena, nothingFromDefaultResource) {
+    const string filePath = string(TEST_DATA_DIR) + "/complex/everything.json";
+    const InputJSON input(filePath);
+    pmr::memory_resource* previous = pmr::set_default_resource(pmr::null_memory_resource());
+    try {
+        const DocumentJSON document(input.view());
+        pmr::set_default_resource(previous);
+        ASSERT_EQ(OBJECT, document.root().at("person").type);
+    } catch(const bad_alloc&) {
+        pmr::set_default_resource(previous);
+        FAIL() << "a value was allocated outside of the document";
+    }
+}
+
+TEST(Arena, moveKeepsValues) {
+    DocumentJSON document(R"({"a": {"b": [1, "a string longer than the small string buffer"]}})");
+    const DocumentJSON moved(std::move(document));
+    const ArrayJSON& array = moved.root().at("a").asObject().at("b").asArray();
+    ASSERT_EQ("a string longer than the small string buffer", array.at(1).asString());
+}
+
+TEST(Arena, borrowsFromInput) {
+    const auto input = make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/complex/everything.json");
+    const string_view json = input->view();
+    const ValueJSON heap(parseJSON(json));
+    const DocumentJSON sequential(input);
+    ASSERT_TRUE(sameValue(heap, ValueJSON(sequential.root())));
+    const DocumentJSON parallel(input, 4, 64);
+    ASSERT_TRUE(sameValue(heap, ValueJSON(parallel.root())));
+    for(const DocumentJSON* document : {&sequential, &parallel}) {
+        const string_view name = document->root().at("person").asObject().at("education").asObject()
+                                 .at("college").asObject().at("name").asString();
+        ASSERT_EQ("University of Springfield", name);
+        ASSERT_TRUE(name.data() > json.data() && name.data() < json.data() + json.size());
+    }
+}
+
+// Values
+TEST(Values, borrowedStrings) {
+    string json = R"({"plain": "a string longer than inline", "escaped": "an \"escaped\" string", "short": "inline"})";
+    KeysJSON keys(pmr::get_default_resource());
+    const ObjectJSON result = parseJSON(json, keys, true);
+    const string_view plain = result.at("plain").asString();
+    ASSERT_EQ(json.data() + json.find("a string"), plain.data());
+    ASSERT_EQ("a string longer than inline", plain);
+    ASSERT_EQ("an \"escaped\" string", result.at("escaped").asString());
+    ASSERT_EQ("inline", result.at("short").asString());
+
+    const ValueJSON copy = result.at("plain");
+    ASSERT_NE(plain.data(), copy.asString().data());
+    json.assign(json.size(), ' ');
+    ASSERT_EQ("a string longer than inline", copy.asString());
+    ASSERT_EQ("an \"escaped\" string", result.at("escaped").asString());
+}
+
+TEST(Values, inlineAndLongStrings) {
+    const ObjectJSON result = parseJSON(R"({"short": "fourteen chars", "long": "fifteen chars!!", "array": ["", "a\tb"]})");
+    ASSERT_EQ("fourteen chars", result.at("short").asString());
+    ASSERT_EQ("fifteen chars!!", result.at("long").asString());
+    ASSERT_EQ("", result.at("array").asArray().at(0).asString());
+    ASSERT_EQ("a\tb", result.at("array").asArray().at(1).asString());
+}
+
+TEST(Values, copiesOutlivePayloads) {
+    optional<ValueJSON> copy;
+    {
+        const DocumentJSON document(R"({"a": {"b": ["a string longer than inline", 2.5, true]}})");
+        ValueJSON value = document.root().at("a");
+        copy = value;
+        const ValueJSON moved = std::move(value);
+        ASSERT_EQ(typeNULL, value.type);
+        ASSERT_EQ(OBJECT, moved.type);
+    }
+    const ArrayJSON& array = copy->asObject().at("b").asArray();
+    ASSERT_EQ("a string longer than inline", array.at(0).asString());
+    ASSERT_DOUBLE_EQ(2.5, array.at(1).asDouble());
+    ASSERT_TRUE(array.at(2).asBool());
+}
+
+TEST(Values, numericColumns) {
+    const ObjectJSON result = parseJSON(R"({"ints": [1, 2, 3], "floats": [1.5, -2.0], "mixed": [1, 2.5],
+                                           "tail": [1, 2, "three"], "empty": []})");
+    const ArrayJSON& ints = result.at("ints").asArray();
+    ASSERT_EQ(INT, ints.column());
+    ASSERT_EQ((vector<long long>{1, 2, 3}), vector(ints.integers().begin(), ints.integers().end()));
+    ASSERT_TRUE(ints.values().empty());
+    ASSERT_THROW((void) ints.at(0), logic_error);
+    ASSERT_EQ(2, ints.item(1).asInt());
+    ASSERT_EQ(FLOAT, result.at("floats").asArray().column());
+    ASSERT_DOUBLE_EQ(-2.0, result.at("floats").asArray().floats()[1]);
+
+    const ArrayJSON& mixed = result.at("mixed").asArray();
+    ASSERT_EQ(typeNULL, mixed.column());
+    ASSERT_EQ(INT, mixed.at(0).type);
+    ASSERT_EQ(FLOAT, mixed.at(1).type);
+    const ArrayJSON& tail = result.at("tail").asArray();
+    ASSERT_EQ(typeNULL, tail.column());
+    ASSERT_EQ(2, tail.at(1).asInt());
+    ASSERT_EQ("three", tail.at(2).asString());
+    ASSERT_EQ(typeNULL, result.at("empty").asArray().column());
+
+    const ValueJSON copy = result.at("ints");
+    ASSERT_EQ(INT, copy.asArray().column());
+    ASSERT_EQ("[ 1, 2, 3 ]", toString(copy));
+}
+
+TEST(Values, serialize) {
+    const ObjectJSON result = parseJSON(R"({"a": [], "b": {}, "c": [[], {}, 1.5, -2e-7, 1e300], "d": null, "e": [true, false]})");
+    ASSERT_EQ(R"({ "a": [], "b": {}, "c": [ [], {}, 1.5, -2e-07, 1e+300 ], "d": null, "e": [ true, false ] })",
+              toString(ValueJSON(result)));
+    string out = "c: ";
+    appendJSON(out, result.at("c"));
+    ASSERT_EQ("c: [ [], {}, 1.5, -2e-07, 1e+300 ]", out);
+}
+
+TEST(Values, writeInChunks) {
+    string json = R"({"strings": [)";
+    for(int i = 0; i < 20000; i++) json += (i > 0 ? "," : "") + string(R"({"i": ")") + to_string(i) + "\"}";
+    json += R"(], "numbers": [)";
+    for(int i = 0; i < 20000; i++) json += (i > 0 ? "," : "") + to_string(i * 0.5);
+    json += "]}";
+    const ValueJSON value(parseJSON(json));
+    ostringstream out;
+    writeJSON(out, value);
+    ASSERT_GT(out.str().size(), 1 << 18);
+    ASSERT_EQ(toString(value), out.str());
+}
+
+TEST(Values, objectsKeepOrder) {
+    const ObjectJSON result = parseJSON(R"({"z": 1, "a": 2, "m": {"y": 3, "b": 4}})");
+    ASSERT_EQ("{ \"z\": 1, \"a\": 2, \"m\": { \"y\": 3, \"b\": 4 } }", toString(ValueJSON(result)));
+}
+
+TEST(Values, wideObjects) {
+    string json = "{";
+    for(int i = 0; i < 100; i++) json += "\"key" + to_string(i) + "\": " + to_string(i) + ",";
+    json.back() = '}';
+    const ObjectJSON result = parseJSON(json);
+    ASSERT_EQ(100, result.size());
+    for(int i = 0; i < 100; i++) {
+        ASSERT_EQ(i, result.at("key" + to_string(i)).asInt());
+        ASSERT_EQ(i, (result.begin() + i)->second.asInt());
+    }
+    ASSERT_FALSE(result.contains("key100"));
+    ASSERT_EQ(result.end(), result.find(string_view("key")));
+    ASSERT_THROW(parseJSON(json.substr(0, json.size() - 1) + R"(, "key57": 0})"), JSONParseException);
+}
+
+// Keys
+TEST(Keys, sharedByObjects) {
+    const DocumentJSON document(R"({"a": [{"customer_account_identifier": 1, "id": 2}, {"customer_account_identifier": 3, "id": 4}],
+                                   "customer_account_identifier": 5})");
+    const ArrayJSON& array = document.root().at("a").asArray();
+    const auto& first = array.at(0).asObject();
+    const auto& second = array.at(1).asObject();
+    const char* interned = first.find("customer_account_identifier")->first.view().data();
+    ASSERT_EQ(interned, second.find("customer_account_identifier")->first.view().data());
+    ASSERT_EQ(interned, document.root().find("customer_account_identifier")->first.view().data());
+    ASSERT_EQ(3, second.at("customer_account_identifier").asInt());
+    ASSERT_EQ(4, second.at("id").asInt());
+}
+
+TEST(Keys, copiesOwnTheirKeys) {
+    optional<ValueJSON> copy;
+    const char* interned;
+    {
+        const DocumentJSON document(R"({"a": {"some_longer_key_name_than_inline": "value"}})");
+        interned = document.root().at("a").asObject().begin()->first.view().data();
+        copy = document.root().at("a");
+    }
+    const ObjectJSON& object = copy->asObject();
+    ASSERT_NE(interned, object.begin()->first.view().data());
+    ASSERT_EQ("some_longer_key_name_than_inline", object.begin()->first.view());
+}
+
+TEST(Keys, lookupWithAnyString) {
+    const DocumentJSON document(R"({"key": 1, "k\u0065y_longer_than_inline_storage": 2})");
+    const ObjectJSON& root = document.root();
+    ASSERT_TRUE(root.contains("key"));
+    ASSERT_TRUE(root.contains(string("key_longer_than_inline_storage")));
+    ASSERT_TRUE(root.contains(string_view("key")));
+    ASSERT_TRUE(root.contains(KeyJSON("key_longer_than_inline_storage")));
+    ASSERT_FALSE(root.contains("ke"));
+    ASSERT_FALSE(root.contains("key_longer_than_inline_storag"));
+}
+
+// Tape
+TEST(Tape, sameAsTree) {
+    for(const string fileName : {"/complex/everything.json", "/complex/bigNoArrays.json", "/test.json"}) {
+        const InputJSON input(string(TEST_DATA_DIR) + fileName);
+        const TapeJSON tape = parseTapeJSON(input.view());
+        ASSERT_TRUE(sameValue(ValueJSON(parseJSON(input.view())), TapeRef::root(tape).toValue()));
+    }
+}
+
+TEST(Tape, skipsContainers) {
+    const TapeJSON tape = parseTapeJSON(R"({"a": {"b": [1, 2.5, [true, null]], "c": "x"}, "d": [], "e": "\u00e9"})");
+    const TapeRef root = TapeRef::root(tape);
+    ASSERT_EQ(3, root.size());
+    const auto b = root.member("a")->member("b");
+    ASSERT_EQ(ARRAY, b->type());
+    ASSERT_EQ(3, b->size());
+    ASSERT_EQ(1, b->item(0)->asInt());
+    ASSERT_EQ(2.5, b->item(1)->asDouble());
+    ASSERT_TRUE(b->item(2)->item(0)->asBool());
+    ASSERT_EQ(typeNULL, b->item(2)->item(1)->type());
+    ASSERT_FALSE(b->item(3));
+    ASSERT_EQ("x", root.member("a")->member("c")->asString());
+    ASSERT_EQ(0, root.member("d")->size());
+    ASSERT_EQ("\xc3\xa9", root.member("e")->asString());
+    ASSERT_FALSE(root.member("f"));
+}
+
+TEST(Tape, invalid) {
+    ASSERT_THROW(parseTapeJSON(R"({"a": 1, "a": 2})"), JSONParseException);
+    ASSERT_THROW(parseTapeJSON(R"({"a": [1, 2})"), JSONParseException);
+}
+
+// Input
+TEST(Input, regularFileIsMapped) {
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    const InputJSON input(filePath);
+    ASSERT_TRUE(input.isMapped());
+    ASSERT_STREQ(R"({"a": { "b": [ 1, 2, { "c": "test" }, [11, 12] ]}})", string(input.view()).c_str());
+}
+
+TEST(Input, missingFile) {
+    const string filePath = string(TEST_DATA_DIR) + "/doesNotExist.json";
+    ASSERT_THROW(InputJSON{filePath}, runtime_error);
+}
+
 // Array
 TEST(ParseArray, simple) {
     const string filePath = string(TEST_DATA_DIR) + "/array/simple.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_EQ(1, result.size());
     ASSERT_TRUE(result.contains("array"));
-    const vector<ValueJSON> array = get<vector<ValueJSON>>(result.at("array").value);
+    const ArrayJSON array = result.at("array").asArray();
     ASSERT_EQ(3, array.size());
-    ASSERT_STREQ("one", get<string>(array.at(0).value).c_str());
-    ASSERT_STREQ("two", get<string>(array.at(1).value).c_str());
-    ASSERT_STREQ("three", get<string>(array.at(2).value).c_str());
+    ASSERT_EQ("one", array.at(0).asString());
+    ASSERT_EQ("two", array.at(1).asString());
+    ASSERT_EQ("three", array.at(2).asString());
 }
 
 TEST(ParseArray, oneItem) {
     const string filePath = string(TEST_DATA_DIR) + "/array/oneItem.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("array"));
-    const vector<ValueJSON> array = get<vector<ValueJSON>>(result.at("array").value);
+    const ArrayJSON array = result.at("array").asArray();
     ASSERT_EQ(1, array.size());
-    ASSERT_STREQ("one", get<string>(array.at(0).value).c_str());
+    ASSERT_EQ("one", array.at(0).asString());
 }
 
 TEST(ParseArray, differentTypeItems) {
     const string filePath = string(TEST_DATA_DIR) + "/array/differentTypeItems.json";
-    const unordered_map<string, ValueJSON> result = parseFileJSON(filePath);
+    const ObjectJSON result = parseFileJSON(filePath);
     ASSERT_TRUE(result.contains("array"));
-    const vector<ValueJSON> array = get<vector<ValueJSON>>(result.at("array").value);
+    const ArrayJSON array = result.at("array").asArray();
     ASSERT_EQ(7, array.size());
-    ASSERT_STREQ("one", get<string>(array.at(0).value).c_str());
+    ASSERT_EQ("one", array.at(0).asString());
     ASSERT_EQ(typeNULL, array.at(1).type);
-    ASSERT_EQ(3, get<long long>(array.at(2).value));
-    ASSERT_TRUE(get<bool>(array.at(3).value));
-    ASSERT_FALSE(get<bool>(array.at(4).value));
-    const unordered_map<string, ValueJSON> obj = get<unordered_map<string, ValueJSON>>(array.at(5).value);
+    ASSERT_EQ(3, array.at(2).asInt());
+    ASSERT_TRUE(array.at(3).asBool());
+    ASSERT_FALSE(array.at(4).asBool());
+    const ObjectJSON obj = array.at(5).asObject();
     ASSERT_EQ(0, obj.size());
-    const vector<ValueJSON> vect = get<vector<ValueJSON>>(array.at(6).value);
+    const ArrayJSON vect = array.at(6).asArray();
     ASSERT_EQ(0, vect.size());
 }
@@ -0,0 +1,22 @@
+#ifndef RESULT_OR_ERROR_H
+#define RESULT_OR_ERROR_H
+#include <string>
+
+#include "../src/JSON.h"
+
+/**
+ * Runs an evaluation for tests that compare two ways of evaluating the same expression
+ *
+ * @param evaluate evaluates an expression and returns its result
+ * @return the result as JSON text, or the message of the exception it threw
+ */
+template<typename Evaluate>
+std::string resultOrError(Evaluate evaluate) {
+    try {
+        return toString(evaluate());
+    } catch (const executeException& e) {
+        return e.what();
+    }
+}
+
+#endif //RESULT_OR_ERROR_H
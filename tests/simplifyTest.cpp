@@ -0,0 +1,72 @@
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "../src/JSON.h"
+#include "resultOrError.h"
+
+using namespace std;
+
+TEST(Simplify, foldsLiterals) {
+    const Node readme = simplifyExpression(parseExpression("2^2 * 9 ^ 0.5 / 3 ^ (2-1)"));
+    ASSERT_EQ(FLOAT_LITERAL, readme.action);
+    ASSERT_DOUBLE_EQ(4, get<double>(readme.value));
+    const Node functions = simplifyExpression(parseExpression("max(1, 2 * 3, min(4, 5.5))"));
+    ASSERT_EQ(FLOAT_LITERAL, functions.action); // min(4, 5.5) is floating point, so is the max
+    ASSERT_DOUBLE_EQ(6, get<double>(functions.value));
+    const Node partly = simplifyExpression(parseExpression("a.b[0] + 2 * 3"));
+    ASSERT_EQ(ADD, partly.action);
+    ASSERT_EQ(INT_LITERAL, partly.children[1].action);
+    ASSERT_EQ(6, get<long long>(partly.children[1].value));
+}
+
+TEST(Simplify, foldsSubscripts) {
+    const Node path = simplifyExpression(parseExpression("a.b[3 - 2]"));
+    const Node& middle = path.children[0].children[0];
+    ASSERT_EQ(INT_LITERAL, middle.subscript->action);
+    ASSERT_EQ(1, get<long long>(middle.subscript->value));
+    const Node nested = simplifyExpression(parseExpression("a.b[a.b[2 ^ 0] * 1 + 1]"));
+    const Node& sum = *nested.children[0].children[0].subscript;
+    ASSERT_EQ(ADD, sum.action);
+    const Node& product = sum.children[0];
+    ASSERT_EQ(MULTIPLY, product.action); // the path could be a string
+    ASSERT_EQ(INT_LITERAL, product.children[0].children[0].children[0].subscript->action);
+    ASSERT_EQ(1, get<long long>(product.children[0].children[0].children[0].subscript->value));
+}
+
+TEST(Simplify, identities) {
+    ASSERT_EQ(SIZE, simplifyExpression(parseExpression("size(a.b) * 1")).action);
+    ASSERT_EQ(SIZE, simplifyExpression(parseExpression("1 * size(a.b) ^ 1 / 1 - 0")).action);
+    ASSERT_EQ(SIZE, simplifyExpression(parseExpression("0 + size(a.b) + 0")).action);
+    ASSERT_EQ(ADD, simplifyExpression(parseExpression("(a.b[0] + 1.5) * 1.0")).action);
+    ASSERT_EQ(SUBTRACT, simplifyExpression(parseExpression("(a.b[0] - 0.5) - 0.0")).action);
+    // kept: a path could be a string, an integer would become floating point, -0.0 + 0 is 0.0
+    ASSERT_EQ(MULTIPLY, simplifyExpression(parseExpression("a.b[0] * 1")).action);
+    ASSERT_EQ(MULTIPLY, simplifyExpression(parseExpression("size(a.b) * 1.0")).action);
+    ASSERT_EQ(ADD, simplifyExpression(parseExpression("(a.b[0] - 0.5) + 0")).action);
+    ASSERT_EQ(ADD, simplifyExpression(parseExpression("a.b[0] + 0")).action);
+}
+
+TEST(Simplify, keepsErrors) {
+    ASSERT_EQ(DIVIDE, simplifyExpression(parseExpression("1 / 0")).action);
+    ASSERT_EQ(DIVIDE, simplifyExpression(parseExpression("1 / (2 - 2)")).action);
+    ASSERT_EQ(SIZE, simplifyExpression(parseExpression("size(1)")).action);
+    ASSERT_DOUBLE_EQ(INFINITY, get<double>(simplifyExpression(parseExpression("1.0 / 0")).value));
+    const DocumentJSON document(make_shared<const InputJSON>(string(TEST_DATA_DIR) + "/test.json"));
+    for(const string expression : {"a.x * 1", "size(a.b[0]) * 1", "(a.b[2] + 1) * 1", "max(a.b) - 0",
+                                   "a.b[a.b[1] * 1 + 0]", "a.b[(a.b[1] + 0.5) * 1.0]", "size(1) * 1",
+                                   "a.b[1] ^ 1 + 2 ^ 3", "(a.b[0] + a.b[1]) * 1.0 / 1"}) {
+        const string parsed = resultOrError([&] { return executeExpression(document.root(), parseExpression(expression)); });
+        const string simplified = resultOrError([&] {
+            return executeExpression(document.root(), simplifyExpression(parseExpression(expression)));
+        });
+        ASSERT_EQ(parsed, simplified) << expression;
+    }
+}
+
+TEST(Simplify, integerPower) {
+    ASSERT_EQ(4052555153018976267, get<long long>(simplifyExpression(parseExpression("3 ^ 39")).value));
+    ASSERT_EQ(1, get<long long>(simplifyExpression(parseExpression("2 ^ (0 - 1)")).value));
+    ASSERT_EQ(-8, get<long long>(simplifyExpression(parseExpression("(0 - 2) ^ 3")).value));
+    const string filePath = string(TEST_DATA_DIR) + "/test.json";
+    ASSERT_EQ(4052555153018976267, JSON(filePath).evaluate("(a.b[0] + 2) ^ 39")->asInt());
+}
@@ -0,0 +1,96 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+#include "../src/JSON.h"
+
+using namespace std;
+
+/**
+ * Copy of a test JSON file in its own temporary directory, removed with the snapshots written next to it
+ */
+class SnapshotTest : public testing::Test {
+protected:
+    filesystem::path directory;
+    string filePath;
+
+    void SetUp() override {
+        directory = filesystem::temp_directory_path()
+                    / ("json_eval_" + string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+        filesystem::create_directories(directory);
+        filePath = (directory / "everything.json").string();
+        filesystem::copy_file(string(TEST_DATA_DIR) + "/complex/everything.json", filePath,
+                              filesystem::copy_options::overwrite_existing);
+        filesystem::remove(snapshotPath(filePath));
+    }
+
+    void TearDown() override {
+        filesystem::remove_all(directory);
+    }
+
+    /**
+     *
+     * @return stamp of the JSON file as it is now
+     */
+    [[nodiscard]] SourceStamp stamp() const {
+        return {filesystem::file_size(filePath),
+                static_cast<int64_t>(filesystem::last_write_time(filePath).time_since_epoch().count()),
+                hashBytes(InputJSON(filePath).view())};
+    }
+};
+
+TEST_F(SnapshotTest, sameAsTape) {
+    const JSON tape = JSON(filePath, TAPE);
+    const JSON written = JSON(filePath, SNAPSHOT);
+    ASSERT_TRUE(filesystem::exists(snapshotPath(filePath)));
+    ASSERT_TRUE(loadSnapshot(snapshotPath(filePath), stamp()));
+    const JSON mapped = JSON(filePath, SNAPSHOT);
+    for(const string expression : {"person.contacts.phone_numbers", "person.education.college.degrees[1].gpa",
+                                   "size(project.versions)", "person.hobbies[1].equipment.lenses[person.age - 34]",
+                                   "person"}) {
+        ASSERT_STREQ(toString(tape.evaluate(expression)).c_str(), toString(written.evaluate(expression)).c_str());
+        ASSERT_STREQ(toString(tape.evaluate(expression)).c_str(), toString(mapped.evaluate(expression)).c_str());
+    }
+}
+
+TEST_F(SnapshotTest, staleSource) {
+    JSON(filePath, SNAPSHOT);
+    const SourceStamp before = stamp();
+    const auto modified = filesystem::last_write_time(filePath);
+    {
+        // same size and modification time, only the hash tells the difference
+        string contents(InputJSON(filePath).view());
+        contents.replace(contents.find("\"age\": 35"), 9, "\"age\": 36");
+        ofstream(filePath, ios::binary | ios::trunc) << contents;
+    }
+    filesystem::last_write_time(filePath, modified);
+    const SourceStamp after = stamp();
+    ASSERT_EQ(before.size, after.size);
+    ASSERT_EQ(before.modified, after.modified);
+    ASSERT_FALSE(loadSnapshot(snapshotPath(filePath), after));
+    ASSERT_EQ(36, JSON(filePath, SNAPSHOT).evaluate("person.age")->asInt());
+    ASSERT_TRUE(loadSnapshot(snapshotPath(filePath), after));
+}
+
+TEST_F(SnapshotTest, truncated) {
+    JSON(filePath, SNAPSHOT);
+    const string path = snapshotPath(filePath);
+    filesystem::resize_file(path, filesystem::file_size(path) - 1);
+    ASSERT_FALSE(loadSnapshot(path, stamp()));
+    ASSERT_EQ(35, JSON(filePath, SNAPSHOT).evaluate("person.age")->asInt());
+    ASSERT_TRUE(loadSnapshot(path, stamp()));
+}
+
+TEST_F(SnapshotTest, corruptedBody) {
+    JSON(filePath, SNAPSHOT);
+    const string path = snapshotPath(filePath);
+    {
+        // the header is intact, one word of the tape points elsewhere
+        fstream file(path, ios::binary | ios::in | ios::out);
+        file.seekp(80);
+        file.put('\x7f');
+    }
+    ASSERT_FALSE(loadSnapshot(path, stamp()));
+    ASSERT_EQ(35, JSON(filePath, SNAPSHOT).evaluate("person.age")->asInt());
+    ASSERT_TRUE(loadSnapshot(path, stamp()));
+}
@@ -0,0 +1,112 @@
+#include "../src/structural.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace std;
+
+/**
+ * Byte by byte version of findContainerEnd
+ */
+string_view::size_type referenceContainerEnd(const string_view json, const string_view::size_type pos) {
+    int depth = 1;
+    bool inString = false;
+    for(string_view::size_type i = pos; i < json.size(); i++) {
+        const char c = json[i];
+        if(inString) {
+            if(c == '"') inString = false;
+            else if(c == '\\') i++;
+        } else if(c == '"') inString = true;
+        else if(c == '{' || c == '[') depth++;
+        else if((c == '}' || c == ']') && --depth == 0) return i;
+    }
+    return string_view::npos;
+}
+
+/**
+ * Byte by byte version of findStringEnd
+ */
+string_view::size_type referenceStringEnd(const string_view json, const string_view::size_type pos) {
+    for(string_view::size_type i = pos; i < json.size(); i++) {
+        if(json[i] == '"') return i;
+        if(json[i] == '\\') i++;
+    }
+    return string_view::npos;
+}
+
+string randomText(mt19937& random, const size_t size) {
+    constexpr char alphabet[] = "\"\\{}[]a \t\n\r\x01\xa0";
+    uniform_int_distribution<int> pick(0, sizeof(alphabet) - 2);
+    string text(size, ' ');
+    for(char& c : text) c = alphabet[pick(random)];
+    return text;
+}
+
+TEST(Structural, classifyMatchesScalar) {
+    mt19937 random(1);
+    for(int i = 0; i < 1000; i++) {
+        const string block = randomText(random, 64);
+        const StructuralMasks expected = classifyBlockScalar(block.data());
+        const StructuralMasks actual = classifyBlock(block.data());
+        ASSERT_EQ(expected.quote, actual.quote);
+        ASSERT_EQ(expected.backslash, actual.backslash);
+        ASSERT_EQ(expected.open, actual.open);
+        ASSERT_EQ(expected.close, actual.close);
+        ASSERT_EQ(expected.whitespace, actual.whitespace);
+    }
+}
+
+TEST(Structural, nonWhitespaceMatchesReference) {
+    mt19937 random(4);
+    for(int i = 0; i < 2000; i++) {
+        const string json = string(i % 150, ' ') + randomText(random, i % 7) + "\n\t";
+        const string_view::size_type expected = min(json.find_first_not_of(" \t\n\r"), json.size());
+        ASSERT_EQ(expected, findNonWhitespace(json, 0)) << json;
+    }
+}
+
+TEST(Structural, escapedQuoteOnBlockBoundary) {
+    const string json = string(63, 'a') + "\\\"b\"";
+    ASSERT_EQ(66, findStringEnd(json, 0));
+}
+
+TEST(Structural, stringEndMatchesReference) {
+    mt19937 random(2);
+    for(int i = 0; i < 2000; i++) {
+        const string json = randomText(random, i % 300);
+        ASSERT_EQ(referenceStringEnd(json, 0), findStringEnd(json, 0)) << json;
+    }
+}
+
+/**
+ * Random brackets and strings, backslashes only appear inside strings like in valid JSON
+ */
+string randomStructure(mt19937& random, const size_t size) {
+    constexpr char outside[] = "{}[]a \"";
+    constexpr char inside[] = "{}[]a \\";
+    constexpr char escaped[] = "\"\\a";
+    uniform_int_distribution<int> pickOutside(0, sizeof(outside) - 2);
+    uniform_int_distribution<int> pickInside(0, sizeof(inside) - 2);
+    uniform_int_distribution<int> pickEscaped(0, sizeof(escaped) - 2);
+    string text;
+    bool inString = false;
+    while(text.size() < size) {
+        const char c = inString ? inside[pickInside(random)] : outside[pickOutside(random)];
+        text += c;
+        if(c == '"') inString = true;
+        else if(inString && c == '\\') text += escaped[pickEscaped(random)];
+        else if(inString && c == ' ') {
+            text += '"';
+            inString = false;
+        }
+    }
+    return text;
+}
+
+TEST(Structural, containerEndMatchesReference) {
+    mt19937 random(3);
+    for(int i = 0; i < 2000; i++) {
+        const string json = randomStructure(random, i % 300);
+        ASSERT_EQ(referenceContainerEnd(json, 0), findContainerEnd(json, 0)) << json;
+    }
+}